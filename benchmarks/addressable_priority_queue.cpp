@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "addressable_priority_queue.hpp"
+#include "lib.hpp"
+
+/// @brief Generates `size` pseudo-random values and the indices of the
+/// `erase_percent` percent of them to erase, in random order, reproducible for
+/// a fixed `seed`.
+[[nodiscard]] static std::pair<std::vector<int>, std::vector<int>> workload(
+    int size, int erase_percent, unsigned int seed) {
+  std::mt19937 gen(seed);
+  std::vector<int> values(size);
+  std::generate(values.begin(), values.end(),
+                [&gen]() { return static_cast<int>(gen() >> 1); });
+  std::vector<int> erased(size);
+  for (int index = 0; index < size; ++index) {
+    erased[index] = index;
+  }
+  std::shuffle(erased.begin(), erased.end(), gen);
+  erased.resize(static_cast<std::size_t>(size) * erase_percent / 100);
+  return {values, erased};
+}
+
+/// @brief Pushes `state.range(0)` values, erases `state.range(1)` percent of
+/// them by value, and pops the rest.
+static void BM_Lazy(benchmark::State& state) {
+  const auto [values, erased] = workload(static_cast<int>(state.range(0)),
+                                         static_cast<int>(state.range(1)), 0);
+  for (auto _ : state) {
+    lazy_priority_queue<int> queue;
+    for (const auto value : values) {
+      queue.push(value);
+    }
+    for (const auto index : erased) {
+      queue.erase(values[index]);
+    }
+    for (; !queue.empty(); queue.pop()) {
+      benchmark::DoNotOptimize(queue.top());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// @brief Pushes `state.range(0)` values, erases `state.range(1)` percent of
+/// them by handle, and pops the rest.
+static void BM_Addressable(benchmark::State& state) {
+  const auto [values, erased] = workload(static_cast<int>(state.range(0)),
+                                         static_cast<int>(state.range(1)), 0);
+  using queue_type = addressable_priority_queue<int>;
+  std::vector<queue_type::handle> handles(values.size());
+  for (auto _ : state) {
+    queue_type queue;
+    for (std::size_t index = 0; index < values.size(); ++index) {
+      handles[index] = queue.push(values[index]);
+    }
+    for (const auto index : erased) {
+      queue.erase(handles[index]);
+    }
+    for (; !queue.empty(); queue.pop()) {
+      benchmark::DoNotOptimize(queue.top());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// @brief Runs a benchmark on 1e6 elements, erasing 0% up to 90% of them.
+static void EraseRatios(benchmark::internal::Benchmark* benchmark) {
+  for (const auto erase_percent : {0, 10, 50, 90}) {
+    benchmark->Args({1'000'000, erase_percent});
+  }
+  benchmark->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_Lazy)->Apply(EraseRatios);
+BENCHMARK(BM_Addressable)->Apply(EraseRatios);
\ No newline at end of file
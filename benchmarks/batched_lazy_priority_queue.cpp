@@ -0,0 +1,90 @@
+#include "batched_lazy_priority_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "lib.hpp"
+
+constexpr int values_per_producer = 100'000;
+
+/// @brief Starts `num_producers` threads that call `produce(index, value)` for
+/// every value they generate, and calls `consume()` on the calling thread
+/// until it has returned every value, yielding whenever it returns none.
+template <class Produce, class Consume>
+void run_producers(int num_producers, Produce produce, Consume consume) {
+  std::vector<std::thread> producers;
+  for (int index = 0; index < num_producers; ++index) {
+    producers.emplace_back([index, &produce] {
+      std::mt19937 gen(index);
+      for (int count = 0; count < values_per_producer; ++count) {
+        produce(index, static_cast<int>(gen() >> 1));
+      }
+    });
+  }
+  for (int consumed = 0; consumed < num_producers * values_per_producer;) {
+    if (const auto count = consume(); count != 0) {
+      consumed += count;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+}
+
+/// @brief Producers push into per-producer rings, the owner pops everything
+/// after every batch.
+static void BM_Batched(benchmark::State& state) {
+  const auto num_producers = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    batched_lazy_priority_queue<int> queue(num_producers);
+    run_producers(
+        num_producers,
+        [&queue](int index, int value) {
+          queue.get_producer(index).push(value);
+        },
+        [&queue] {
+          int popped = 0;
+          for (; !queue.empty(); ++popped) {
+            benchmark::DoNotOptimize(queue.extract_top());
+          }
+          return popped;
+        });
+  }
+  state.SetItemsProcessed(state.iterations() * num_producers *
+                          values_per_producer);
+}
+
+/// @brief The baseline: producers push into a lazy priority queue behind a
+/// mutex, the owner pops under the same mutex.
+static void BM_Locked(benchmark::State& state) {
+  const auto num_producers = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    std::mutex mutex;
+    lazy_priority_queue<int> queue;
+    run_producers(
+        num_producers,
+        [&](int /*index*/, int value) {
+          const std::lock_guard lock(mutex);
+          queue.push(value);
+        },
+        [&] {
+          const std::lock_guard lock(mutex);
+          int popped = 0;
+          for (; !queue.empty(); ++popped) {
+            benchmark::DoNotOptimize(queue.extract_top());
+          }
+          return popped;
+        });
+  }
+  state.SetItemsProcessed(state.iterations() * num_producers *
+                          values_per_producer);
+}
+
+BENCHMARK(BM_Batched)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+BENCHMARK(BM_Locked)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "concurrent_lazy_priority_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <optional>
+#include <random>
+
+#include "lib.hpp"
+
+/// @brief A lazy priority queue behind a single mutex, the baseline that the
+/// sharded queue replaces.
+class locked_lazy_priority_queue {
+ public:
+  void push(int value) {
+    const std::lock_guard lock(mutex_);
+    queue_.push(value);
+  }
+
+  std::optional<int> try_pop() {
+    const std::lock_guard lock(mutex_);
+    if (queue_.empty()) {
+      return std::nullopt;
+    }
+    const auto value = queue_.top();
+    queue_.pop();
+    return value;
+  }
+
+ private:
+  std::mutex mutex_;
+  lazy_priority_queue<int> queue_;
+};
+
+/// @brief Every thread pushes and pops one element per iteration on a queue
+/// shared by all threads. Erasures are left out, since another thread may pop
+/// the element before it is erased.
+template <class Queue>
+static void BM_PushPop(benchmark::State& state) {
+  static Queue queue;
+  std::mt19937 gen(state.thread_index());
+  for (auto _ : state) {
+    queue.push(static_cast<int>(gen() >> 1));
+    benchmark::DoNotOptimize(queue.try_pop());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_PushPop, locked_lazy_priority_queue)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PushPop, concurrent_lazy_priority_queue<int>)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
\ No newline at end of file
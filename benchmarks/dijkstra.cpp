@@ -0,0 +1,92 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "lib.hpp"
+
+struct edge {
+  int target;
+  std::uint64_t weight;
+};
+
+/// @brief Generates a random directed graph with `num_nodes` nodes and
+/// `degree` outgoing edges per node, reproducible for a fixed `seed`.
+[[nodiscard]] std::vector<std::vector<edge>> random_graph(int num_nodes,
+                                                          int degree,
+                                                          unsigned int seed) {
+  std::mt19937 gen(seed);
+  std::vector<std::vector<edge>> graph(num_nodes);
+  for (auto& edges : graph) {
+    for (int index = 0; index < degree; ++index) {
+      edges.push_back({static_cast<int>(gen() % num_nodes), 1 + gen() % 1000});
+    }
+  }
+  return graph;
+}
+
+using distance_node = std::pair<std::uint64_t, int>;
+using dijkstra_queue =
+    lazy_priority_queue<distance_node, std::vector<distance_node>,
+                        std::greater<distance_node>>;
+
+/// @brief Computes the distances from node 0 with Dijkstra's algorithm,
+/// decreasing keys with `decrease_key(queue, old_value, new_value)`.
+template <class DecreaseKey>
+[[nodiscard]] std::vector<std::uint64_t> dijkstra(
+    const std::vector<std::vector<edge>>& graph, DecreaseKey decrease_key) {
+  constexpr auto infinity = std::numeric_limits<std::uint64_t>::max();
+  std::vector<std::uint64_t> distances(graph.size(), infinity);
+  dijkstra_queue queue;
+  distances[0] = 0;
+  queue.push({0, 0});
+  while (!queue.empty()) {
+    const auto [distance, node] = queue.extract_top();
+    for (const auto& [target, weight] : graph[node]) {
+      const auto candidate = distance + weight;
+      if (candidate >= distances[target]) {
+        continue;
+      }
+      if (distances[target] == infinity) {
+        queue.push({candidate, target});
+      } else {
+        decrease_key(queue, distance_node{distances[target], target},
+                     distance_node{candidate, target});
+      }
+      distances[target] = candidate;
+    }
+  }
+  return distances;
+}
+
+static void BM_DijkstraUpdate(benchmark::State& state) {
+  const auto graph = random_graph(static_cast<int>(state.range(0)), 8, 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dijkstra(
+        graph, [](dijkstra_queue& queue, const distance_node& old_value,
+                  const distance_node& new_value) {
+          queue.update(old_value, new_value);
+        }));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_DijkstraErasePush(benchmark::State& state) {
+  const auto graph = random_graph(static_cast<int>(state.range(0)), 8, 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(dijkstra(
+        graph, [](dijkstra_queue& queue, const distance_node& old_value,
+                  const distance_node& new_value) {
+          queue.erase(old_value);
+          queue.push(new_value);
+        }));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_DijkstraUpdate)->RangeMultiplier(10)->Range(1'000, 1'000'000);
+BENCHMARK(BM_DijkstraErasePush)->RangeMultiplier(10)->Range(1'000, 1'000'000);
\ No newline at end of file
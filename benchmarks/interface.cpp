@@ -0,0 +1,212 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "lib.hpp"
+
+/// @brief Generates `size` pseudo-random values, reproducible for a fixed
+/// `seed`.
+[[nodiscard]] std::vector<int> random_values(size_t size, unsigned int seed) {
+  std::mt19937 gen(seed);
+  std::vector<int> values(size);
+  std::generate(values.begin(), values.end(),
+                [&gen]() { return static_cast<int>(gen() >> 1); });
+  return values;
+}
+
+template <class Heap>
+using queue_type =
+    lazy_priority_queue<int, std::vector<int>, std::less<int>, Heap>;
+
+template <class Heap>
+static void BM_Push(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  for (auto _ : state) {
+    queue_type<Heap> queue;
+    for (const auto& value : values) {
+      queue.push(value);
+    }
+    benchmark::DoNotOptimize(queue);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Heap>
+static void BM_PushRange(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  for (auto _ : state) {
+    queue_type<Heap> queue;
+    queue.push(values.cbegin(), values.cend());
+    benchmark::DoNotOptimize(queue);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Heap>
+static void BM_Erase(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    queue_type<Heap> queue(values.cbegin(), values.cend());
+    state.ResumeTiming();
+    for (const auto& value : values) {
+      queue.erase(value);
+    }
+    benchmark::DoNotOptimize(queue);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Heap>
+static void BM_Purge(benchmark::State& state) {
+  // Erasing the larger half purges all of it from the top of the heap
+  auto values = random_values(state.range(0), 0);
+  std::sort(values.begin(), values.end());
+  const auto middle = std::next(values.cbegin(), values.size() / 2);
+  for (auto _ : state) {
+    state.PauseTiming();
+    queue_type<Heap> queue(values.cbegin(), values.cend());
+    state.ResumeTiming();
+    queue.erase(middle, values.cend());
+    benchmark::DoNotOptimize(queue.top());
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          std::distance(middle, values.cend()));
+}
+
+template <class Heap>
+static void BM_Pop(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    queue_type<Heap> queue(values.cbegin(), values.cend());
+    state.ResumeTiming();
+    while (!queue.empty()) {
+      queue.pop();
+    }
+    benchmark::DoNotOptimize(queue);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Heap>
+static void BM_DrainSorted(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  std::vector<int> sorted(values.size());
+  for (auto _ : state) {
+    state.PauseTiming();
+    queue_type<Heap> queue(values.cbegin(), values.cend());
+    state.ResumeTiming();
+    queue.drain_sorted(sorted.begin());
+    benchmark::DoNotOptimize(sorted.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <class Heap>
+static void BM_Merge(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  const auto other_values = random_values(state.range(0), 1);
+  for (auto _ : state) {
+    state.PauseTiming();
+    queue_type<Heap> queue(values.cbegin(), values.cend());
+    queue_type<Heap> other(other_values.cbegin(), other_values.cend());
+    state.ResumeTiming();
+    queue.merge(std::move(other));
+    benchmark::DoNotOptimize(queue);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// @brief Restores a queue from an in-memory snapshot, to compare a warm
+/// restart with rebuilding the queue by `BM_Push`.
+template <class Heap>
+static void BM_Deserialize(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  queue_type<Heap> queue(values.cbegin(), values.cend());
+  std::stringstream snapshot;
+  queue.serialize(snapshot);
+  for (auto _ : state) {
+    snapshot.seekg(0);
+    benchmark::DoNotOptimize(queue_type<Heap>::deserialize(snapshot));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// @brief Builds and drains a short-lived queue, as a server would per
+/// request, with memory from the default allocator.
+static void BM_ShortLived(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  for (auto _ : state) {
+    lazy_priority_queue<int> queue;
+    queue.push(values.cbegin(), values.cend());
+    for (; !queue.empty(); queue.pop()) {
+      benchmark::DoNotOptimize(queue.top());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// @brief Builds and drains a short-lived queue, as a server would per
+/// request, with memory from a monotonic buffer that is reused across queues.
+static void BM_ShortLivedPmr(benchmark::State& state) {
+  const auto values = random_values(state.range(0), 0);
+  std::vector<std::byte> buffer(2 * values.size() * sizeof(int));
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size());
+    pmr::lazy_priority_queue<int> queue(&resource);
+    queue.reserve(values.size());
+    queue.push(values.cbegin(), values.cend());
+    for (; !queue.empty(); queue.pop()) {
+      benchmark::DoNotOptimize(queue.top());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_ShortLived)->RangeMultiplier(8)->Range(8, 4'096);
+BENCHMARK(BM_ShortLivedPmr)->RangeMultiplier(8)->Range(8, 4'096);
+
+/// @brief Runs a benchmark on queues of 1e3 up to 1e6 elements.
+static void QueueSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(10)->Range(1'000, 1'000'000);
+}
+
+BENCHMARK_TEMPLATE(BM_Push, binary_heap)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Push, d_ary_heap<4>)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Push, d_ary_heap<8>)->Apply(QueueSizes);
+
+BENCHMARK_TEMPLATE(BM_PushRange, binary_heap)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_PushRange, d_ary_heap<4>)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_PushRange, d_ary_heap<8>)->Apply(QueueSizes);
+
+BENCHMARK_TEMPLATE(BM_Erase, binary_heap)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Erase, d_ary_heap<4>)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Erase, d_ary_heap<8>)->Apply(QueueSizes);
+
+BENCHMARK_TEMPLATE(BM_Purge, binary_heap)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Purge, d_ary_heap<4>)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Purge, d_ary_heap<8>)->Apply(QueueSizes);
+
+BENCHMARK_TEMPLATE(BM_Pop, binary_heap)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Pop, d_ary_heap<4>)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Pop, d_ary_heap<8>)->Apply(QueueSizes);
+
+BENCHMARK_TEMPLATE(BM_DrainSorted, binary_heap)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_DrainSorted, d_ary_heap<4>)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_DrainSorted, d_ary_heap<8>)->Apply(QueueSizes);
+
+BENCHMARK_TEMPLATE(BM_Merge, binary_heap)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Merge, d_ary_heap<4>)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Merge, d_ary_heap<8>)->Apply(QueueSizes);
+
+BENCHMARK_TEMPLATE(BM_Deserialize, binary_heap)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Deserialize, d_ary_heap<4>)->Apply(QueueSizes);
+BENCHMARK_TEMPLATE(BM_Deserialize, d_ary_heap<8>)->Apply(QueueSizes);
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "lazy_coalesced_priority_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include "lib.hpp"
+#include "set_difference/generate_queries.hpp"
+
+/// @brief Processes `state.range(0)` insertions and half as many removals of
+/// values below `state.range(1)`, then drains the queue.
+template <class Queue>
+static void BM_LowCardinality(benchmark::State& state) {
+  const auto num_insertions = static_cast<unsigned int>(state.range(0));
+  const auto queries = generate_random_queries(
+      num_insertions, num_insertions / 2,
+      static_cast<unsigned int>(state.range(1)), 0);
+  for (auto _ : state) {
+    Queue queue;
+    for (const auto& query : queries) {
+      if (query >= 0) {
+        queue.push(query);
+      } else {
+        queue.erase(~query);
+      }
+    }
+    for (; !queue.empty(); queue.pop()) {
+      benchmark::DoNotOptimize(queue.top());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK_TEMPLATE(BM_LowCardinality, lazy_priority_queue<int>)
+    ->ArgsProduct({{100'000, 1'000'000}, {16, 1'024, 1'000'000}});
+BENCHMARK_TEMPLATE(BM_LowCardinality, lazy_coalesced_priority_queue<int>)
+    ->ArgsProduct({{100'000, 1'000'000}, {16, 1'024, 1'000'000}});
\ No newline at end of file
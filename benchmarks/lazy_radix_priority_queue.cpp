@@ -0,0 +1,49 @@
+#include "lazy_radix_priority_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "lib.hpp"
+
+/// @brief Simulates a timer queue of `state.range(0)` pending keys: every step
+/// pops the smallest key, schedules a later one, and schedules and cancels
+/// another one.
+template <class Queue>
+static void BM_Monotone(benchmark::State& state) {
+  const auto size = static_cast<std::uint64_t>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::mt19937 gen(0);
+    Queue queue;
+    for (std::uint64_t key = 0; key < size; ++key) {
+      queue.push(gen() % size);
+    }
+    state.ResumeTiming();
+    for (std::uint64_t step = 0; step < size; ++step) {
+      const std::uint64_t key = queue.top();
+      queue.pop();
+      queue.push(key + gen() % size);
+      const std::uint64_t cancelled = key + gen() % size;
+      queue.push(cancelled);
+      queue.erase(cancelled);
+    }
+    benchmark::DoNotOptimize(queue);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+using radix_queue = lazy_radix_priority_queue<std::uint64_t>;
+using heap_queue =
+    lazy_priority_queue<std::uint64_t, std::vector<std::uint64_t>,
+                        std::greater<std::uint64_t>>;
+
+BENCHMARK_TEMPLATE(BM_Monotone, radix_queue)
+    ->RangeMultiplier(10)
+    ->Range(1'000, 1'000'000);
+BENCHMARK_TEMPLATE(BM_Monotone, heap_queue)
+    ->RangeMultiplier(10)
+    ->Range(1'000, 1'000'000);
\ No newline at end of file
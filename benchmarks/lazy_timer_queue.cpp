@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "lazy_timer_queue.hpp"
+
+using time_point = std::chrono::steady_clock::time_point;
+using timer = std::tuple<time_point, std::uint64_t, int>;
+
+/// @brief Timers in a `lazy_timer_queue`, cancelled by lazy removal.
+class lazy_timers {
+ public:
+  using handle = lazy_timer_queue<int>::handle;
+
+  handle schedule(time_point deadline, int value) {
+    return timers_.schedule(deadline, value);
+  }
+
+  void cancel(const handle& timer) { timers_.cancel(timer); }
+
+  void pop_expired(time_point now, std::vector<int>& fired) {
+    timers_.pop_expired(now, std::back_inserter(fired));
+  }
+
+ private:
+  lazy_timer_queue<int> timers_;
+};
+
+/// @brief Timers in a balanced search tree, cancelled by erasing them.
+class set_timers {
+ public:
+  using handle = std::set<timer>::const_iterator;
+
+  handle schedule(time_point deadline, int value) {
+    return timers_.emplace(deadline, next_id_++, value).first;
+  }
+
+  void cancel(const handle& timer) { timers_.erase(timer); }
+
+  void pop_expired(time_point now, std::vector<int>& fired) {
+    while (!timers_.empty() && std::get<0>(*timers_.begin()) <= now) {
+      fired.push_back(std::get<2>(*timers_.begin()));
+      timers_.erase(timers_.begin());
+    }
+  }
+
+ private:
+  std::set<timer> timers_;
+  std::uint64_t next_id_{};
+};
+
+/// @brief Timers in a binary heap, cancelled by flagging them so that they
+/// are skipped once they reach the top. Flagged timers stay in the heap until
+/// their deadline passes.
+class flag_timers {
+ public:
+  using handle = std::uint64_t;
+
+  handle schedule(time_point deadline, int value) {
+    timers_.emplace(deadline, cancelled_.size(), value);
+    cancelled_.push_back(false);
+    return cancelled_.size() - 1;
+  }
+
+  void cancel(const handle& timer) { cancelled_[timer] = true; }
+
+  void pop_expired(time_point now, std::vector<int>& fired) {
+    while (!timers_.empty() && std::get<0>(timers_.top()) <= now) {
+      if (!cancelled_[std::get<1>(timers_.top())]) {
+        fired.push_back(std::get<2>(timers_.top()));
+      }
+      timers_.pop();
+    }
+  }
+
+ private:
+  std::priority_queue<timer, std::vector<timer>, std::greater<timer>> timers_;
+  std::vector<bool> cancelled_;
+};
+
+/// @brief Schedules `state.range(0)` timers with random deadlines, cancels
+/// `state.range(1)` percent of them in random order, then fires the rest in 64
+/// steps of time.
+template <class Timers>
+static void BM_Timers(benchmark::State& state) {
+  const auto num_timers = static_cast<int>(state.range(0));
+  const auto num_cancelled = num_timers * state.range(1) / 100;
+  std::mt19937 gen(0);
+  std::vector<std::chrono::nanoseconds> deadlines(num_timers);
+  for (auto& deadline : deadlines) {
+    deadline = std::chrono::nanoseconds(gen() % num_timers);
+  }
+  std::vector<int> cancelled(num_timers);
+  std::iota(cancelled.begin(), cancelled.end(), 0);
+  std::shuffle(cancelled.begin(), cancelled.end(), gen);
+  cancelled.resize(num_cancelled);
+
+  std::vector<typename Timers::handle> handles(num_timers);
+  std::vector<int> fired;
+  for (auto _ : state) {
+    Timers timers;
+    for (int index = 0; index < num_timers; ++index) {
+      handles[index] = timers.schedule(time_point(deadlines[index]), index);
+    }
+    for (const auto index : cancelled) {
+      timers.cancel(handles[index]);
+    }
+    for (int step = 1; step <= 64; ++step) {
+      fired.clear();
+      timers.pop_expired(
+          time_point(std::chrono::nanoseconds(
+              static_cast<std::int64_t>(num_timers) * step / 64)),
+          fired);
+      benchmark::DoNotOptimize(fired.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_timers);
+}
+
+BENCHMARK_TEMPLATE(BM_Timers, lazy_timers)
+    ->Args({1 << 20, 50})
+    ->Args({1 << 20, 90})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Timers, set_timers)
+    ->Args({1 << 20, 50})
+    ->Args({1 << 20, 90})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Timers, flag_timers)
+    ->Args({1 << 20, 50})
+    ->Args({1 << 20, 90})
+    ->Unit(benchmark::kMillisecond);
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "set_difference/process_queries.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <iterator>
+#include <vector>
+
+#include "set_difference/generate_queries.hpp"
+
+/// @brief Generates `num_insertions` insertions and half as many removals
+/// with values below `num_insertions`, on all hardware threads.
+[[nodiscard]] std::vector<int> benchmark_queries(
+    const benchmark::State& state) {
+  const auto num_insertions = static_cast<unsigned int>(state.range(0));
+  std::vector<int> queries;
+  queries.reserve(num_insertions + num_insertions / 2);
+  generate_random_queries_parallel(num_insertions, num_insertions / 2,
+                                   num_insertions, 0,
+                                   std::back_inserter(queries));
+  return queries;
+}
+
+static void BM_ProcessQueriesSort(benchmark::State& state) {
+  const auto queries = benchmark_queries(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(process_queries_sort(queries));
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_ProcessQueriesRadix(benchmark::State& state) {
+  const auto queries = benchmark_queries(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(process_queries_radix(queries));
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_ProcessQueriesCounting(benchmark::State& state) {
+  const auto queries = benchmark_queries(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(process_queries_counting(queries));
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_ProcessQueriesMultiset(benchmark::State& state) {
+  const auto queries = benchmark_queries(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(process_queries_multiset(queries));
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_ProcessQueriesLazyPQ(benchmark::State& state) {
+  const auto queries = benchmark_queries(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(process_queries_lazypq(queries));
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_ProcessQueriesParallel(benchmark::State& state) {
+  const auto queries = benchmark_queries(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(process_queries_parallel(queries));
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(BM_ProcessQueriesSort)
+    ->RangeMultiplier(10)
+    ->Range(1'000, 100'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ProcessQueriesRadix)
+    ->RangeMultiplier(10)
+    ->Range(1'000, 100'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ProcessQueriesCounting)
+    ->RangeMultiplier(10)
+    ->Range(1'000, 100'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ProcessQueriesMultiset)
+    ->RangeMultiplier(10)
+    ->Range(1'000, 100'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ProcessQueriesLazyPQ)
+    ->RangeMultiplier(10)
+    ->Range(1'000, 100'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ProcessQueriesParallel)
+    ->RangeMultiplier(10)
+    ->Range(1'000, 100'000'000)
+    ->Unit(benchmark::kMillisecond);
\ No newline at end of file
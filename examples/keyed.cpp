@@ -0,0 +1,56 @@
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "lazy_keyed_priority_queue.hpp"
+
+struct Event {
+  int priority{};
+  int id{};
+  std::string description;
+
+  friend std::ostream& operator<<(std::ostream& os, Event const& e) {
+    return os << "{ " << e.priority << ", " << e.id << ", \"" << e.description
+              << "\" } ";
+  }
+};
+
+// Events are ordered by priority and removed by (priority, id) only, so
+// removals never copy the description
+struct EventKey {
+  std::pair<int, int> operator()(Event const& e) const {
+    return {e.priority, e.id};
+  }
+};
+
+int main() {
+  lazy_keyed_priority_queue<Event, EventKey> events;
+
+  std::cout << "Fill the events queue:\n";
+
+  for (auto const& e : {Event{6, 0, "listen"},
+                        {8, 1, "init"},
+                        {7, 2, "index"},
+                        {9, 3, "start"},
+                        {1, 4, "teardown"},
+                        {4, 5, "evict"}}) {
+    std::cout << e << ' ';
+    events.push(e);
+  }
+
+  std::cout << "\n"
+               "Remove events from the queue by key:\n";
+
+  for (auto const& key : {std::make_pair(7, 2), std::make_pair(4, 5)}) {
+    std::cout << "{ " << key.first << ", " << key.second << " } ";
+    events.erase(key);
+  }
+
+  std::cout << "\n"
+               "Process events:\n";
+
+  for (; !events.empty(); events.pop()) {
+    Event const& e = events.top();
+    std::cout << e << ' ';
+  }
+}
\ No newline at end of file
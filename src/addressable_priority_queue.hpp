@@ -0,0 +1,254 @@
+/**
+ * @file
+ * @brief Defines a priority queue whose elements are removed eagerly through
+ * handles returned on insertion.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/// @brief A priority queue that keeps the position of every element in an
+/// `Arity`-ary heap, so that an element can be removed or changed through the
+/// handle returned when it was pushed, in O(log n) time and with its memory
+/// released immediately. Compared to `lazy_priority_queue`, every operation
+/// pays for maintaining the positions, but removed elements never linger and
+/// removing an element that is no longer in the queue is detected instead of
+/// being undefined behavior.
+///
+/// Handles are small values. A handle outlives its element: once the element
+/// is popped or erased, the handle is reported as stale even if its slot is
+/// reused by a later element. A slot is reused at most 2^32 - 1 times and
+/// then retired, which costs a few bytes per 2^32 removals.
+/// @tparam T The type of the stored elements.
+/// @tparam Compare A Compare type providing a strict weak ordering, see
+/// `lazy_priority_queue`.
+/// @tparam Arity The number of children of every heap node, at least 2.
+template <class T, class Compare = std::less<T>, std::size_t Arity = 2>
+class addressable_priority_queue {
+  static_assert(Arity >= 2, "a heap node has at least two children");
+
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using const_reference = const T&;
+
+  /// @brief Identifies an element pushed to the queue.
+  struct handle {
+    /// @brief The slot that holds the position of the element.
+    std::uint32_t slot;
+    /// @brief The number of elements that used the slot before this one.
+    std::uint32_t generation;
+  };
+
+  /// @brief Default constructor. Value-initializes the comparator.
+  addressable_priority_queue() = default;
+
+  /// @brief Copy-constructs the comparison functor from `compare`.
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  explicit addressable_priority_queue(const Compare& compare)
+      : comp_(compare) {}
+
+  /// @brief Returns reference to the top element, the greatest one by
+  /// default. The behavior is undefined if the queue is empty.
+  /// @see pop()
+  [[nodiscard]] const_reference top() const { return heap_.front().value; }
+
+  /// @brief Checks if the queue has no elements.
+  /// @see size()
+  [[nodiscard]] bool empty() const { return heap_.empty(); }
+
+  /// @brief Returns the number of elements in the queue.
+  /// @see empty()
+  [[nodiscard]] int size() const { return static_cast<int>(heap_.size()); }
+
+  /// @brief Checks if the element identified by `element` is in the queue.
+  /// @param element a handle returned by `push()` or `emplace()`
+  /// @return `false` if the element was popped or erased, `true` otherwise
+  [[nodiscard]] bool contains(const handle& element) const {
+    return element.slot < slots_.size() &&
+           slots_[element.slot].generation == element.generation &&
+           slots_[element.slot].position != npos;
+  }
+
+  /// @brief Pushes the given element value to the queue.
+  /// @param value the value of the element to push
+  /// @return The handle that identifies the element.
+  /// @see erase()
+  handle push(const value_type& value) { return emplace(value); }
+
+  /// @brief Moves the given element value to the queue.
+  /// @param value the value of the element to push
+  /// @return The handle that identifies the element.
+  /// @see erase()
+  handle push(value_type&& value) { return emplace(std::move(value)); }
+
+  /// @brief Pushes a new element constructed in-place from `args`. If an
+  /// exception is thrown, the queue is unchanged.
+  /// @param args arguments to forward to the constructor of the element
+  /// @return The handle that identifies the element.
+  /// @see erase()
+  template <class... Args>
+  handle emplace(Args&&... args) {
+    // Everything that may throw happens before a slot is taken
+    node entry{value_type(std::forward<Args>(args)...), 0};
+    if (free_slots_.empty() && slots_.size() == slots_.capacity()) {
+      slots_.reserve(2 * slots_.size() + 1);
+    }
+    // Every slot may be freed at once, so freeing one never reallocates
+    if (free_slots_.capacity() < slots_.capacity()) {
+      free_slots_.reserve(slots_.capacity());
+    }
+    heap_.push_back(std::move(entry));
+    const auto slot = acquire_slot(heap_.size() - 1);
+    heap_.back().slot = slot;
+    sift_up(heap_.size() - 1);
+    return {slot, slots_[slot].generation};
+  }
+
+  /// @brief Removes the top element from the queue.
+  /// @see top()
+  void pop() { remove_at(0); }
+
+  /// @brief Removes the top element from the queue and returns it.
+  /// @return The former top element
+  /// @see pop()
+  [[nodiscard]] value_type extract_top() {
+    value_type value = std::move(heap_.front().value);
+    remove_at(0);
+    return value;
+  }
+
+  /// @brief Removes the element identified by `element` from the queue.
+  /// @param element a handle returned by `push()` or `emplace()`
+  /// @return `true` if the element was removed, `false` if it was already
+  /// popped or erased
+  /// @see contains()
+  bool erase(const handle& element) {
+    if (!contains(element)) {
+      return false;
+    }
+    remove_at(slots_[element.slot].position);
+    return true;
+  }
+
+  /// @brief Replaces the element identified by `element` with `value` and
+  /// moves it up or down the heap, e.g. to decrease a key.
+  /// @param element a handle returned by `push()` or `emplace()`
+  /// @param value the new value of the element
+  /// @return `true` if the element was updated, `false` if it was already
+  /// popped or erased
+  bool update(const handle& element, value_type value) {
+    if (!contains(element)) {
+      return false;
+    }
+    const auto position = slots_[element.slot].position;
+    heap_[position].value = std::move(value);
+    sift_down(sift_up(position));
+    return true;
+  }
+
+ private:
+  static constexpr size_type npos = static_cast<size_type>(-1);
+  static constexpr std::uint32_t max_generation = UINT32_MAX;
+
+  struct node {
+    value_type value;
+    std::uint32_t slot;
+  };
+
+  struct slot_state {
+    size_type position;
+    std::uint32_t generation;
+  };
+
+  /// @brief Takes a free slot, or a new one, for the node at `position`.
+  /// Does not throw if `slots_` has room for a new slot.
+  std::uint32_t acquire_slot(size_type position) {
+    if (free_slots_.empty()) {
+      slots_.push_back({position, 0});
+      return static_cast<std::uint32_t>(slots_.size() - 1);
+    }
+    const auto slot = free_slots_.back();
+    free_slots_.pop_back();
+    slots_[slot].position = position;
+    return slot;
+  }
+
+  /// @brief Removes the node at `position`. Freeing its slot does not throw,
+  /// since `emplace()` keeps room in `free_slots_` for every slot.
+  void remove_at(size_type position) {
+    auto& slot = slots_[heap_[position].slot];
+    slot.position = npos;
+    // A slot whose generation would wrap around is retired, so that no
+    // stale handle ever matches it again
+    if (slot.generation != max_generation) {
+      ++slot.generation;
+      free_slots_.push_back(heap_[position].slot);
+    }
+    if (position + 1 != heap_.size()) {
+      move_to(position, std::move(heap_.back()));
+      heap_.pop_back();
+      sift_down(sift_up(position));
+    } else {
+      heap_.pop_back();
+    }
+  }
+
+  /// @brief Stores `entry` at `position` and records its new position.
+  void move_to(size_type position, node&& entry) {
+    slots_[entry.slot].position = position;
+    heap_[position] = std::move(entry);
+  }
+
+  /// @brief Moves the node at `position` up while it comes after its parent.
+  /// @return The final position of the node
+  size_type sift_up(size_type position) {
+    if (position == 0 ||
+        !comp_(heap_[(position - 1) / Arity].value, heap_[position].value)) {
+      return position;
+    }
+    node entry = std::move(heap_[position]);
+    do {
+      const auto parent = (position - 1) / Arity;
+      move_to(position, std::move(heap_[parent]));
+      position = parent;
+    } while (position > 0 &&
+             comp_(heap_[(position - 1) / Arity].value, entry.value));
+    move_to(position, std::move(entry));
+    return position;
+  }
+
+  /// @brief Moves the node at `position` down while a child comes after it.
+  void sift_down(size_type position) {
+    const auto size = heap_.size();
+    node entry = std::move(heap_[position]);
+    for (auto child = position * Arity + 1; child < size;
+         child = position * Arity + 1) {
+      auto best = child;
+      const auto last_child = std::min(child + Arity, size);
+      for (++child; child < last_child; ++child) {
+        if (comp_(heap_[best].value, heap_[child].value)) {
+          best = child;
+        }
+      }
+      if (!comp_(entry.value, heap_[best].value)) {
+        break;
+      }
+      move_to(position, std::move(heap_[best]));
+      position = best;
+    }
+    move_to(position, std::move(entry));
+  }
+
+  Compare comp_;
+  std::vector<node> heap_;
+  std::vector<slot_state> slots_;
+  std::vector<std::uint32_t> free_slots_;
+};
\ No newline at end of file
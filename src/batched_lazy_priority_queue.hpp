@@ -0,0 +1,241 @@
+/**
+ * @file
+ * @brief Defines a lazy priority queue fed by many producer threads through
+ * lock-free rings and consumed by a single owner thread.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "heap.hpp"
+#include "lib.hpp"
+
+/// @brief A priority queue with implicit removals whose insertions and
+/// removals come from several producer threads, while a single owner thread
+/// reads and pops the elements. Every producer has its own bounded
+/// single-producer single-consumer ring of pending operations, so producers
+/// never contend with each other and never block the owner. The owner applies
+/// all pending operations in one batch before serving `top()`, `pop()` and
+/// the other queries: pushes with one bulk `push()`, which rebuilds the heap
+/// in linear time when the batch is large, and removals with one bulk
+/// `erase()`.
+///
+/// Operations of one producer are applied in order. Operations of different
+/// producers that are pending at the same time are applied pushes first, so
+/// an element may be erased through another producer than the one that
+/// pushed it, as long as the removal is enqueued after the insertion. The
+/// rings are read one after another, so a removal read from one ring may
+/// belong to an insertion that reached an earlier ring after it was read.
+/// `drain()` therefore reads every ring twice and applies the removals read
+/// by the second pass with the next batch, by which time their insertions
+/// have been read.
+/// @tparam T The type of the stored elements, which must be default
+/// constructible.
+/// @tparam Container The type of the underlying container, see
+/// `lazy_priority_queue`.
+/// @tparam Compare A Compare type providing a strict weak ordering, see
+/// `lazy_priority_queue`.
+/// @tparam Heap A heap policy, see `lazy_priority_queue`.
+template <class T, class Container = std::vector<T>,
+          class Compare = std::less<typename Container::value_type>,
+          class Heap = binary_heap>
+class batched_lazy_priority_queue {
+  struct ring;
+
+ public:
+  using value_type = typename Container::value_type;
+  using size_type = std::size_t;
+  using const_reference = typename Container::const_reference;
+
+  /// @brief Enqueues operations from a single producer thread. A producer is
+  /// cheap to copy, but every ring must be used by one thread at a time.
+  class producer {
+   public:
+    /// @brief Enqueues pushing `value` unless the ring is full.
+    /// @param value the value of the element to push
+    /// @return `false` if the ring is full, `true` otherwise
+    [[nodiscard]] bool try_push(const value_type& value) {
+      return ring_->try_enqueue(value, false);
+    }
+
+    /// @brief Enqueues pushing `value`, yielding while the ring is full.
+    /// @param value the value of the element to push
+    void push(const value_type& value) {
+      while (!try_push(value)) {
+        std::this_thread::yield();
+      }
+    }
+
+    /// @brief Enqueues erasing `value` unless the ring is full. The behavior
+    /// is undefined if the element is not present in the queue once the
+    /// removal is applied.
+    /// @param value the value of the element to remove
+    /// @return `false` if the ring is full, `true` otherwise
+    [[nodiscard]] bool try_erase(const value_type& value) {
+      return ring_->try_enqueue(value, true);
+    }
+
+    /// @brief Enqueues erasing `value`, yielding while the ring is full.
+    /// @param value the value of the element to remove
+    void erase(const value_type& value) {
+      while (!try_erase(value)) {
+        std::this_thread::yield();
+      }
+    }
+
+   private:
+    friend class batched_lazy_priority_queue;
+
+    explicit producer(ring& ring) : ring_(&ring) {}
+
+    ring* ring_;
+  };
+
+  /// @brief Constructs an empty queue with `num_producers` rings.
+  /// @param num_producers the number of producers, at least one
+  /// @param ring_capacity the smallest number of pending operations every ring
+  /// can hold, rounded up to a power of two
+  /// @param compare the comparison function object of the underlying queue
+  explicit batched_lazy_priority_queue(size_type num_producers,
+                                       size_type ring_capacity = 1024,
+                                       const Compare& compare = Compare())
+      : queue_(compare) {
+    for (size_type index = 0; index < std::max<size_type>(num_producers, 1);
+         ++index) {
+      rings_.emplace_back(ring_capacity);
+    }
+  }
+
+  /// @brief Returns the number of producers.
+  [[nodiscard]] size_type num_producers() const { return rings_.size(); }
+
+  /// @brief Returns the producer that enqueues into the `index`-th ring.
+  /// @param index the index of the ring, less than `num_producers()`
+  [[nodiscard]] producer get_producer(size_type index) {
+    return producer(rings_[index]);
+  }
+
+  /// @brief Applies every operation enqueued before the call to the
+  /// underlying queue. Removals enqueued during the call may be held back
+  /// until the next call. Only the owner thread may call this function.
+  /// @return The number of operations dequeued from the rings.
+  size_type drain() {
+    const auto num_held = erases_.size();
+    // The insertion of every removal read by the first pass was enqueued
+    // before the second pass started, so both passes together read it
+    for (auto& ring : rings_) {
+      ring.dequeue_into(pushes_, erases_);
+    }
+    for (auto& ring : rings_) {
+      ring.dequeue_into(pushes_, held_erases_);
+    }
+    const auto num_operations =
+        pushes_.size() + erases_.size() - num_held + held_erases_.size();
+    queue_.push(pushes_.cbegin(), pushes_.cend());
+    queue_.erase(erases_.cbegin(), erases_.cend());
+    pushes_.clear();
+    erases_.clear();
+    erases_.swap(held_erases_);
+    return num_operations;
+  }
+
+  /// @brief Applies pending operations, then returns reference to the top
+  /// element. Only the owner thread may call this function.
+  /// @see lazy_priority_queue::top()
+  [[nodiscard]] const_reference top() {
+    drain();
+    return queue_.top();
+  }
+
+  /// @brief Applies pending operations, then checks if the queue is empty.
+  /// Only the owner thread may call this function.
+  /// @see lazy_priority_queue::empty()
+  [[nodiscard]] bool empty() {
+    drain();
+    return queue_.empty();
+  }
+
+  /// @brief Applies pending operations, then returns the number of elements.
+  /// Only the owner thread may call this function.
+  /// @see lazy_priority_queue::size()
+  [[nodiscard]] int size() {
+    drain();
+    return queue_.size();
+  }
+
+  /// @brief Applies pending operations, then removes the top element. Only
+  /// the owner thread may call this function.
+  /// @see lazy_priority_queue::pop()
+  void pop() {
+    drain();
+    queue_.pop();
+  }
+
+  /// @brief Applies pending operations, then removes the top element and
+  /// returns it. Only the owner thread may call this function.
+  /// @see lazy_priority_queue::extract_top()
+  [[nodiscard]] value_type extract_top() {
+    drain();
+    return queue_.extract_top();
+  }
+
+ private:
+  // A bounded single-producer single-consumer ring. The producer only writes
+  // tail and the consumer only writes head, each on its own cache line.
+  struct ring {
+    struct operation {
+      value_type value;
+      bool erase;
+    };
+
+    explicit ring(size_type min_capacity) {
+      size_type capacity = 1;
+      while (capacity < min_capacity) {
+        capacity *= 2;
+      }
+      operations.resize(capacity);
+    }
+
+    bool try_enqueue(const value_type& value, bool erase) {
+      const auto last = tail.load(std::memory_order_relaxed);
+      if (last - head.load(std::memory_order_acquire) == operations.size()) {
+        return false;
+      }
+      auto& operation = operations[last & (operations.size() - 1)];
+      operation.value = value;
+      operation.erase = erase;
+      tail.store(last + 1, std::memory_order_release);
+      return true;
+    }
+
+    void dequeue_into(std::vector<value_type>& pushes,
+                      std::vector<value_type>& erases) {
+      const auto first = head.load(std::memory_order_relaxed);
+      const auto last = tail.load(std::memory_order_acquire);
+      for (auto index = first; index != last; ++index) {
+        auto& operation = operations[index & (operations.size() - 1)];
+        auto& batch = operation.erase ? erases : pushes;
+        batch.push_back(std::move(operation.value));
+      }
+      head.store(last, std::memory_order_release);
+    }
+
+    std::vector<operation> operations;
+    alignas(64) std::atomic<size_type> head{};
+    alignas(64) std::atomic<size_type> tail{};
+  };
+
+  lazy_priority_queue<T, Container, Compare, Heap> queue_;
+  std::deque<ring> rings_;
+  std::vector<value_type> pushes_;
+  std::vector<value_type> erases_;
+  std::vector<value_type> held_erases_;
+};
\ No newline at end of file
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @brief Defines a priority queue that retains only its best k elements.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <set>
+
+/// @brief A priority queue with removals that holds at most `capacity`
+/// elements, the best ones pushed so far: pushing into a full queue evicts
+/// the element that would be popped last, or drops the pushed one if it would
+/// come after every element. Memory stays O(capacity) regardless of the
+/// length of the stream of pushes and removals.
+///
+/// The elements are kept in a single ordered multiset of at most `capacity`
+/// elements, whose ends serve `top()` and `bottom()`, so every operation takes
+/// O(log capacity) time. A value may be erased whether it was retained,
+/// evicted or dropped, as in a stream of insertions and retractions: erasing
+/// a value that is not retained has no effect. Values are told apart by
+/// equivalence under `Compare`, so erasing a value removes a retained value
+/// equivalent to it, which may be a different one if several are retained.
+/// @tparam T The type of the stored elements.
+/// @tparam Compare A Compare type providing a strict weak ordering, see
+/// `lazy_priority_queue`.
+template <class T, class Compare = std::less<T>>
+class bounded_lazy_priority_queue {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using const_reference = const T&;
+
+  /// @brief Constructs an empty queue that holds at most `capacity`
+  /// elements.
+  /// @param capacity the largest number of elements in the queue
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  explicit bounded_lazy_priority_queue(size_type capacity,
+                                       const Compare& compare = Compare())
+      : capacity_(capacity), retained_(compare) {}
+
+  /// @brief Returns reference to the top element, the one that `pop()`
+  /// removes.
+  /// @see bottom()
+  [[nodiscard]] const_reference top() const { return *retained_.rbegin(); }
+
+  /// @brief Returns reference to the bottom element, the one that a push into
+  /// a full queue evicts.
+  /// @see top()
+  [[nodiscard]] const_reference bottom() const { return *retained_.begin(); }
+
+  /// @brief Checks if the queue has no elements.
+  /// @see size()
+  [[nodiscard]] bool empty() const { return retained_.empty(); }
+
+  /// @brief Returns the number of elements in the queue, at most
+  /// `capacity()`.
+  /// @see empty()
+  [[nodiscard]] int size() const { return static_cast<int>(retained_.size()); }
+
+  /// @brief Returns the largest number of elements in the queue.
+  [[nodiscard]] size_type capacity() const { return capacity_; }
+
+  /// @brief Pushes the given element value to the queue. If the queue is
+  /// full, evicts `bottom()` if `value` comes after it, and drops `value`
+  /// otherwise.
+  /// @param value the value of the element to push
+  /// @return `true` if `value` was retained, `false` if it was dropped
+  /// @see erase()
+  bool push(const value_type& value) {
+    if (retained_.size() >= capacity_) {
+      if (empty() || !retained_.value_comp()(bottom(), value)) {
+        return false;
+      }
+      retained_.erase(retained_.begin());
+    }
+    retained_.insert(value);
+    return true;
+  }
+
+  /// @brief Removes the top element from the queue.
+  /// @see top()
+  void pop() { retained_.erase(std::prev(retained_.end())); }
+
+  /// @brief Removes the value from the queue if it is retained, and does
+  /// nothing if it was evicted, dropped or never pushed.
+  /// @param value the value of the element to remove
+  /// @return `true` if the value was removed, `false` if it was ignored
+  /// @see push()
+  bool erase(const value_type& value) {
+    const auto it = retained_.find(value);
+    if (it == retained_.end()) {
+      return false;
+    }
+    retained_.erase(it);
+    return true;
+  }
+
+ private:
+  size_type capacity_;
+  std::multiset<value_type, Compare> retained_;
+};
\ No newline at end of file
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @brief Defines a concurrent relaxed priority queue built from internally
+ * locked lazy priority queue shards.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "lib.hpp"
+
+/// @brief A thread-safe relaxed priority queue with implicit removals in the
+/// MultiQueue style. Elements are distributed over several
+/// `lazy_priority_queue` shards, each protected by its own mutex. An element
+/// is placed into the shard selected by its hash, so that `erase()` reaches
+/// the shard that holds it. `try_pop()` compares the tops of two random shards
+/// and pops the better one.
+///
+/// The popped element is not necessarily the top of the whole queue. With p
+/// shards and well-mixed hashes, the rank of the popped element among all
+/// elements in the queue is O(p) in expectation and O(p log p) with high
+/// probability, see Rihani, Sanders, Dementiev, "MultiQueues: Simple Relaxed
+/// Concurrent Priority Queues" (SPAA 2015) and Alistarh et al., "The Power of
+/// Choice in Priority Scheduling" (PODC 2017). That analysis assumes that
+/// elements are placed uniformly at random, which placement by hash only
+/// approximates when values are distinct or nearly so: equal values, and
+/// values that collide under `Hash`, always share a shard, so k copies of the
+/// top value are popped one at a time from a single shard and the rank error
+/// grows with k. Hashes are mixed before use, which spreads distinct values
+/// but cannot spread duplicates.
+/// @tparam T The type of the stored elements.
+/// @tparam Container The type of the underlying container of each shard, see
+/// `lazy_priority_queue`.
+/// @tparam Compare A Compare type providing a strict weak ordering, see
+/// `lazy_priority_queue`.
+/// @tparam Hash A Hash type consistent with `operator==` of `T`, used to route
+/// both insertions and removals of a value to the same shard.
+template <class T, class Container = std::vector<T>,
+          class Compare = std::less<typename Container::value_type>,
+          class Hash = std::hash<typename Container::value_type>>
+class concurrent_lazy_priority_queue {
+ public:
+  using value_type = typename Container::value_type;
+  using size_type = std::size_t;
+
+  /// @brief Constructs an empty queue with `num_shards` shards.
+  /// @param num_shards the number of shards, by default twice the number of
+  /// hardware threads, but at least one; more shards reduce contention but
+  /// increase the rank error of `try_pop()`
+  /// @param compare the comparison function object of every shard
+  /// @param hash the hash function object used to select shards
+  explicit concurrent_lazy_priority_queue(
+      size_type num_shards = 2 * std::thread::hardware_concurrency(),
+      const Compare& compare = Compare(), const Hash& hash = Hash())
+      : comp_(compare), hash_(hash) {
+    for (size_type index = 0; index < std::max<size_type>(num_shards, 1);
+         ++index) {
+      shards_.emplace_back(comp_);
+    }
+  }
+
+  /// @brief Returns the number of shards.
+  [[nodiscard]] size_type num_shards() const { return shards_.size(); }
+
+  /// @brief Checks whether every shard is empty. The result may be outdated
+  /// as soon as it is returned if other threads modify the queue.
+  /// @return `true` if every shard was empty when it was inspected
+  /// @see size()
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  /// @brief Returns the total number of elements in all shards. The result
+  /// may be outdated as soon as it is returned if other threads modify the
+  /// queue.
+  /// @return The sum of the sizes of all shards.
+  /// @see empty()
+  [[nodiscard]] int size() const {
+    int size = 0;
+    for (const auto& shard : shards_) {
+      const std::lock_guard lock(shard.mutex);
+      size += shard.queue.size();
+    }
+    return size;
+  }
+
+  /// @brief Pushes the given element value to the shard selected by its hash.
+  /// @param value the value of the element to push
+  /// @see try_pop()
+  void push(const value_type& value) {
+    auto& shard = shard_of(value);
+    const std::lock_guard lock(shard.mutex);
+    shard.queue.push(value);
+  }
+
+  /// @brief Removes the value from the shard selected by its hash. The
+  /// behavior is undefined if the element is not present in the queue, in
+  /// particular if it was popped concurrently.
+  /// @param value the value of the element to remove
+  /// @see try_pop()
+  void erase(const value_type& value) {
+    auto& shard = shard_of(value);
+    const std::lock_guard lock(shard.mutex);
+    shard.queue.erase(value);
+  }
+
+  /// @brief Removes and returns an element close to the top of the queue.
+  /// Locks two random shards and pops the better of their tops. Falls back to
+  /// scanning every shard if both random shards are empty.
+  /// @return The popped element, or `std::nullopt` if every shard was empty
+  /// when it was inspected.
+  std::optional<value_type> try_pop() {
+    thread_local std::minstd_rand gen(static_cast<std::uint_fast32_t>(
+        std::hash<std::thread::id>()(std::this_thread::get_id())));
+    const auto first = gen() % shards_.size();
+    const auto second = gen() % shards_.size();
+    if (first == second) {
+      if (auto value = pop_from(shards_[first])) {
+        return value;
+      }
+    } else {
+      std::scoped_lock lock(shards_[first].mutex, shards_[second].mutex);
+      auto& first_queue = shards_[first].queue;
+      auto& second_queue = shards_[second].queue;
+      if (!first_queue.empty() || !second_queue.empty()) {
+        auto& queue = first_queue.empty() ||
+                              (!second_queue.empty() &&
+                               comp_(first_queue.top(), second_queue.top()))
+                          ? second_queue
+                          : first_queue;
+        return queue.extract_top();
+      }
+    }
+
+    for (auto& shard : shards_) {
+      if (auto value = pop_from(shard)) {
+        return value;
+      }
+    }
+    return std::nullopt;
+  }
+
+ private:
+  // Aligned to a typical cache line to avoid false sharing between shards
+  struct alignas(64) shard {
+    explicit shard(const Compare& compare) : queue(compare) {}
+
+    mutable std::mutex mutex;
+    lazy_priority_queue<T, Container, Compare> queue;
+  };
+
+  [[nodiscard]] shard& shard_of(const value_type& value) {
+    // Placement must be a function of the value so that erase() finds the
+    // shard without a lookup table, which is why duplicates share a shard.
+    // Mixes the hash, since e.g. std::hash<int> is the identity
+    auto bits = static_cast<std::uint64_t>(hash_(value));
+    bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    bits = (bits ^ (bits >> 27)) * 0x94d049bb133111ebULL;
+    bits ^= bits >> 31;
+    return shards_[bits % shards_.size()];
+  }
+
+  static std::optional<value_type> pop_from(shard& shard) {
+    const std::lock_guard lock(shard.mutex);
+    if (shard.queue.empty()) {
+      return std::nullopt;
+    }
+    return shard.queue.extract_top();
+  }
+
+  Compare comp_;
+  Hash hash_;
+  std::deque<shard> shards_;
+};
\ No newline at end of file
@@ -0,0 +1,193 @@
+/**
+ * @file
+ * @brief Defines heap policies that maintain an implicit heap in a random
+ * access range.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+#include "simd.hpp"
+
+/// @brief Binary heap policy backed by `std::push_heap`, `std::pop_heap` and
+/// `std::make_heap`. Suitable for any range accepted by the standard heap
+/// algorithms.
+struct binary_heap {
+  /// @brief The number of children of every inner node.
+  static constexpr std::size_t arity = 2;
+
+  /// @brief Inserts the element at `last - 1` into the heap `{first, last -
+  /// 1}`.
+  template <class RandomIt, class Compare>
+  static void push(RandomIt first, RandomIt last, Compare comp) {
+    std::push_heap(first, last, comp);
+  }
+
+  /// @brief Moves the top element of the heap `{first, last}` to `last - 1`
+  /// and makes `{first, last - 1}` a heap.
+  template <class RandomIt, class Compare>
+  static void pop(RandomIt first, RandomIt last, Compare comp) {
+    std::pop_heap(first, last, comp);
+  }
+
+  /// @brief Makes a heap out of the range `{first, last}`.
+  template <class RandomIt, class Compare>
+  static void make(RandomIt first, RandomIt last, Compare comp) {
+    std::make_heap(first, last, comp);
+  }
+
+  /// @brief Restores the heap property of `{first, last}` after its top
+  /// element was replaced.
+  template <class RandomIt, class Compare>
+  static void replace_top(RandomIt first, RandomIt last, Compare comp);
+};
+
+/// @brief Implicit d-ary heap policy. Children of the node `i` are stored at
+/// `Arity * i + 1, ..., Arity * i + Arity`. A wider heap is shallower and keeps
+/// siblings in adjacent memory, which trades extra comparisons in `pop()` for
+/// fewer cache misses on large heaps. With 4 or 8 children, `int`, `float`,
+/// `double` and `std::uint64_t` keys in a `std::vector` ordered by `std::less`
+/// or `std::greater` select the best child with SIMD instructions where
+/// available.
+/// @tparam Arity the number of children of every inner node, at least 2
+template <std::size_t Arity>
+struct d_ary_heap {
+  static_assert(Arity >= 2, "a heap node must have at least two children");
+
+  /// @brief The number of children of every inner node.
+  static constexpr std::size_t arity = Arity;
+
+  /// @brief Inserts the element at `last - 1` into the heap `{first, last -
+  /// 1}`.
+  template <class RandomIt, class Compare>
+  static void push(RandomIt first, RandomIt last, Compare comp) {
+    if (first != last) {
+      sift_up(first, std::distance(first, last) - 1, comp);
+    }
+  }
+
+  /// @brief Moves the top element of the heap `{first, last}` to `last - 1`
+  /// and makes `{first, last - 1}` a heap.
+  template <class RandomIt, class Compare>
+  static void pop(RandomIt first, RandomIt last, Compare comp) {
+    const auto size = std::distance(first, last);
+    if (size > 1) {
+      std::iter_swap(first, std::prev(last));
+      sift_down(first, size - 1, 0, comp);
+    }
+  }
+
+  /// @brief Restores the heap property of `{first, last}` after its top
+  /// element was replaced.
+  template <class RandomIt, class Compare>
+  static void replace_top(RandomIt first, RandomIt last, Compare comp) {
+    const auto size = std::distance(first, last);
+    if (size > 1) {
+      sift_down(first, size, 0, comp);
+    }
+  }
+
+  /// @brief Makes a heap out of the range `{first, last}`.
+  template <class RandomIt, class Compare>
+  static void make(RandomIt first, RandomIt last, Compare comp) {
+    const auto size = std::distance(first, last);
+    if (size < 2) {
+      return;
+    }
+    for (auto hole = (size - 2) / static_cast<decltype(size)>(Arity);
+         hole >= 0; --hole) {
+      sift_down(first, size, hole, comp);
+    }
+  }
+
+ private:
+  template <class RandomIt, class Compare>
+  static void sift_up(
+      RandomIt first,
+      typename std::iterator_traits<RandomIt>::difference_type hole,
+      Compare& comp) {
+    using difference_type =
+        typename std::iterator_traits<RandomIt>::difference_type;
+    typename std::iterator_traits<RandomIt>::value_type value =
+        std::move(first[hole]);
+    while (hole > 0) {
+      const auto parent = (hole - 1) / static_cast<difference_type>(Arity);
+      if (!comp(first[parent], value)) {
+        break;
+      }
+      first[hole] = std::move(first[parent]);
+      hole = parent;
+    }
+    first[hole] = std::move(value);
+  }
+
+  /// @brief Returns the position of the first child in `{child, last_child}`
+  /// that no other child comes after. A full set of arithmetic siblings
+  /// ordered by `std::less` or `std::greater` is compared with SIMD
+  /// instructions if the CPU supports them, unless the kernels are compiled
+  /// out, see `simd.hpp`.
+  template <class RandomIt, class Compare>
+  static typename std::iterator_traits<RandomIt>::difference_type best_child(
+      RandomIt first,
+      typename std::iterator_traits<RandomIt>::difference_type child,
+      typename std::iterator_traits<RandomIt>::difference_type last_child,
+      Compare& comp) {
+#ifdef LAZY_PRIORITY_QUEUE_X86_SIMD
+    using value_type = typename std::iterator_traits<RandomIt>::value_type;
+    if constexpr (simd::is_vectorizable_v<Arity, RandomIt, Compare>) {
+      if (last_child - child == static_cast<decltype(child)>(Arity) &&
+          simd::supported<Arity, value_type>()) {
+        return child +
+               static_cast<decltype(child)>(
+                   simd::best_of<Arity,
+                                 simd::selects_greatest_v<Compare, value_type>>(
+                       &first[child]));
+      }
+    }
+#endif
+    auto best = child;
+    for (auto sibling = child + 1; sibling < last_child; ++sibling) {
+      if (comp(first[best], first[sibling])) {
+        best = sibling;
+      }
+    }
+    return best;
+  }
+
+  template <class RandomIt, class Compare>
+  static void sift_down(
+      RandomIt first,
+      typename std::iterator_traits<RandomIt>::difference_type size,
+      typename std::iterator_traits<RandomIt>::difference_type hole,
+      Compare& comp) {
+    using difference_type =
+        typename std::iterator_traits<RandomIt>::difference_type;
+    typename std::iterator_traits<RandomIt>::value_type value =
+        std::move(first[hole]);
+    while (true) {
+      const auto child = static_cast<difference_type>(Arity) * hole + 1;
+      if (child >= size) {
+        break;
+      }
+      const auto last_child =
+          std::min(child + static_cast<difference_type>(Arity), size);
+      const auto best = best_child(first, child, last_child, comp);
+      if (!comp(value, first[best])) {
+        break;
+      }
+      first[hole] = std::move(first[best]);
+      hole = best;
+    }
+    first[hole] = std::move(value);
+  }
+};
+
+// The standard heap algorithms have no sift-down of their own, and a binary
+// heap laid out by them is a 2-ary heap
+template <class RandomIt, class Compare>
+void binary_heap::replace_top(RandomIt first, RandomIt last, Compare comp) {
+  d_ary_heap<2>::replace_top(first, last, comp);
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+/**
+ * @file
+ * @brief Defines a lazy priority queue that coalesces equal elements into
+ * counted runs.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/// @brief A priority queue with implicit removals that stores equal pending
+/// removals, and optionally equal insertions, as a single value with a count.
+/// Removals are counted in a hash table instead of a second heap, so
+/// `erase()` takes expected constant time, and once a value reaches the top
+/// all of its pending removals are annihilated in a single step. This pays
+/// off when few distinct values are inserted and removed many times. As with
+/// `lazy_priority_queue`, the behavior is undefined if the element being
+/// removed was not present in the queue.
+/// @tparam T The type of the stored elements.
+/// @tparam Compare A Compare type providing a strict weak ordering, see
+/// `lazy_priority_queue`.
+/// @tparam Hash A Hash type consistent with `KeyEqual`.
+/// @tparam KeyEqual A type that tells whether two elements are equal, which
+/// is how a removal is matched to an insertion.
+/// @tparam CoalesceInsertions If `true`, the heap holds every distinct value
+/// only once together with the number of its insertions, so its size is the
+/// number of distinct values. Otherwise, every insertion has its own heap
+/// entry and only the removals are coalesced.
+template <class T, class Compare = std::less<T>, class Hash = std::hash<T>,
+          class KeyEqual = std::equal_to<T>, bool CoalesceInsertions = true>
+class lazy_coalesced_priority_queue {
+ public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using const_reference = const T&;
+
+  /// @brief Default constructor. Value-initializes the comparator, the hash
+  /// function, the equality predicate, and the underlying containers.
+  lazy_coalesced_priority_queue() : lazy_coalesced_priority_queue(Compare()) {}
+
+  /// @brief Copy-constructs the comparison functor, the hash function and the
+  /// equality predicate. Value-initializes the underlying containers.
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  /// @param hash the hash function object of the underlying hash table
+  /// @param equal the equality predicate of the underlying hash table
+  explicit lazy_coalesced_priority_queue(const Compare& compare,
+                                         const Hash& hash = Hash(),
+                                         const KeyEqual& equal = KeyEqual())
+      : comp_(compare), counts_(0, hash, equal) {}
+
+  /// @brief Pushes every element from the `{first, last}` range and
+  /// copy-constructs the comparison functor from `compare`.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of elements to initialize with
+  /// @param last the end of the range of elements to initialize with
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  template <class InputIt>
+  lazy_coalesced_priority_queue(InputIt first, InputIt last,
+                                const Compare& compare = Compare())
+      : lazy_coalesced_priority_queue(compare) {
+    push(first, last);
+  }
+
+  /// @brief Returns reference to the top element in the priority queue. This
+  /// element will be removed on a call to `pop()`. Annihilates all pending
+  /// removals of the elements that reach the top on the way.
+  /// @return Reference to the top element
+  /// @see pop()
+  [[nodiscard]] const_reference top() const {
+    while (!counts_.empty()) {
+      const auto it = counts_.find(insert_.front());
+      if (it == counts_.end() || it->second.removed == 0) {
+        break;
+      }
+      auto& [inserted, removed] = it->second;
+      if constexpr (CoalesceInsertions) {
+        const auto annihilated = std::min(inserted, removed);
+        inserted -= annihilated;
+        removed -= annihilated;
+        if (inserted != 0) {
+          break;
+        }
+      } else {
+        --removed;
+      }
+      std::pop_heap(insert_.begin(), insert_.end(), comp_);
+      insert_.pop_back();
+      if (inserted == 0 && removed == 0) {
+        counts_.erase(it);
+      }
+    }
+    return insert_.front();
+  }
+
+  /// @brief Checks if the queue has no elements, i.e. whether every inserted
+  /// element has been removed
+  /// @return `true` if the queue is empty, `false` otherwise
+  /// @see size()
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+  /// @brief Returns the number of elements in the queue, that is, the number
+  /// of inserted elements minus the number of removed elements
+  /// @return The number of elements in the queue.
+  /// @see empty()
+  [[nodiscard]] int size() const { return static_cast<int>(size_); }
+
+  /// @brief Pushes the given element value to the priority queue. If
+  /// `CoalesceInsertions` is set and an equal element is already in the
+  /// queue, only its count is incremented.
+  /// @param value the value of the element to push
+  /// @see pop()
+  void push(const value_type& value) {
+    if constexpr (CoalesceInsertions) {
+      if (counts_[value].inserted++ != 0) {
+        ++size_;
+        return;
+      }
+    }
+    insert_.push_back(value);
+    std::push_heap(insert_.begin(), insert_.end(), comp_);
+    ++size_;
+  }
+
+  /// @brief Pushes the given range of value to the priority queue.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of elements to push
+  /// @param last the end of the range of elements to push
+  /// @see pop()
+  template <class InputIt>
+  void push(InputIt first, InputIt last) {
+    for (auto it = first; it != last; ++it) {
+      push(*it);
+    }
+  }
+
+  /// @brief Removes the top element from the priority queue.
+  /// @see push()
+  /// @see top()
+  void pop() {
+    const auto& value = top();
+    if constexpr (CoalesceInsertions) {
+      const auto it = counts_.find(value);
+      if (--it->second.inserted != 0) {
+        --size_;
+        return;
+      }
+      if (it->second.removed == 0) {
+        counts_.erase(it);
+      }
+    }
+    std::pop_heap(insert_.begin(), insert_.end(), comp_);
+    insert_.pop_back();
+    --size_;
+  }
+
+  /// @brief Removes the value from the priority queue by incrementing its
+  /// count of pending removals.
+  /// @param value the value of the element to remove
+  /// @see pop()
+  void erase(const value_type& value) {
+    ++counts_[value].removed;
+    --size_;
+  }
+
+  /// @brief Removes the given range of value from the priority queue.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of elements to remove
+  /// @param last the end of the range of elements to remove
+  /// @see pop()
+  template <class InputIt>
+  void erase(InputIt first, InputIt last) {
+    for (auto it = first; it != last; ++it) {
+      erase(*it);
+    }
+  }
+
+  /// @brief Returns the number of entries in the underlying heap, which is
+  /// the number of distinct values if `CoalesceInsertions` is set.
+  [[nodiscard]] size_type heap_size() const { return insert_.size(); }
+
+ private:
+  struct multiplicity {
+    size_type inserted{};
+    size_type removed{};
+  };
+
+  Compare comp_;
+  mutable std::vector<T> insert_;
+  mutable std::unordered_map<T, multiplicity, Hash, KeyEqual> counts_;
+  size_type size_{};
+};
\ No newline at end of file
@@ -0,0 +1,276 @@
+/**
+ * @file
+ * @brief Defines a lazy priority queue that orders and removes elements by a
+ * compact key.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "heap.hpp"
+
+/// @brief A priority queue with implicit removals that orders elements by the
+/// key that `KeyOf` extracts from them, and removes elements by that key.
+/// Only the keys of removed elements are stored, so tombstones of large
+/// elements stay small and matching them is a cheap key comparison. Removal is
+/// otherwise as lazy as in `lazy_priority_queue`, and the behavior is
+/// undefined if no element with the key being removed is present in the
+/// queue.
+///
+/// Keys must identify elements, e.g. by combining a priority with a unique
+/// id, and `Compare` must order distinct keys strictly, so that the removed
+/// key at the top of the remove heap always meets the same key at the top of
+/// the insert heap.
+/// @tparam T The type of the stored elements.
+/// @tparam KeyOf A function object type that returns the key of an element.
+/// @tparam Container The type of the underlying insert container, see
+/// `lazy_priority_queue`. Keys are stored in a `std::vector`.
+/// @tparam Compare A Compare type providing a strict weak ordering of keys,
+/// see `lazy_priority_queue`.
+/// @tparam Heap A heap policy that maintains both underlying containers, see
+/// `lazy_priority_queue`.
+template <class T, class KeyOf, class Container = std::vector<T>,
+          class Compare = std::less<std::decay_t<std::invoke_result_t<
+              KeyOf, const typename Container::value_type&>>>,
+          class Heap = binary_heap>
+class lazy_keyed_priority_queue {
+ public:
+  using value_type = typename Container::value_type;
+  using key_type =
+      std::decay_t<std::invoke_result_t<KeyOf, const value_type&>>;
+  using size_type = typename Container::size_type;
+  using const_reference = typename Container::const_reference;
+
+  /// @brief Default constructor. Value-initializes the comparator, the key
+  /// extractor and the underlying containers.
+  lazy_keyed_priority_queue() : lazy_keyed_priority_queue(Compare()) {}
+
+  /// @brief Copy-constructs the comparison functor from `compare` and the key
+  /// extractor from `key_of`. Value-initializes the underlying containers.
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  /// @param key_of the function object that extracts keys of elements
+  explicit lazy_keyed_priority_queue(const Compare& compare,
+                                     const KeyOf& key_of = KeyOf())
+      : comp_(compare), key_of_(key_of) {}
+
+  /// @brief Constructs the underlying insert container from the `{first,
+  /// last}` range. Copy-constructs the comparison functor from `compare` and
+  /// the key extractor from `key_of`. Calls `Heap::make`.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of elements to initialize with
+  /// @param last the end of the range of elements to initialize with
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  /// @param key_of the function object that extracts keys of elements
+  template <class InputIt>
+  lazy_keyed_priority_queue(InputIt first, InputIt last,
+                            const Compare& compare = Compare(),
+                            const KeyOf& key_of = KeyOf())
+      : comp_(compare), key_of_(key_of), insert_(first, last) {
+    Heap::make(insert_.begin(), insert_.end(), value_compare());
+  }
+
+  /// @brief Returns reference to the top element in the priority queue, the
+  /// one with the greatest key by default. This element will be removed on a
+  /// call to `pop()`. Every modifier purges removed elements from the top, so
+  /// this function does not modify the queue.
+  /// @return Reference to the top element as if obtained by a call to
+  /// `insert_.front()`
+  /// @see pop()
+  /// @see purge()
+  [[nodiscard]] const_reference top() const { return insert_.front(); }
+
+  /// @brief Discards elements with removed keys from the top of the queue
+  /// until the key of the top element has not been removed. Every modifier
+  /// calls this function before returning, so calling it again has no effect.
+  /// @see top()
+  /// @see compact()
+  void purge() {
+    while (!insert_.empty() && !remove_.empty() &&
+           remove_.front() == key_of_(insert_.front())) {
+      Heap::pop(insert_.begin(), insert_.end(), value_compare());
+      insert_.pop_back();
+      Heap::pop(remove_.begin(), remove_.end(), comp_);
+      remove_.pop_back();
+    }
+  }
+
+  /// @brief Checks if the queue has no elements, i.e. whether `insert_`
+  /// contains elements whose keys `remove_` does not
+  /// @return `true` if the queue is empty, `false` otherwise
+  /// @see size()
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  /// @brief Returns the number of elements in the queue, that is,
+  /// `insert_.size() - remove_.size()`
+  /// @return The number of elements in the queue.
+  /// @see empty()
+  [[nodiscard]] int size() const {
+    return static_cast<int>(insert_.size()) - static_cast<int>(remove_.size());
+  }
+
+  /// @brief Pushes the given element value to the priority queue.
+  /// @param value the value of the element to push
+  /// @see emplace()
+  /// @see pop()
+  void push(const value_type& value) {
+    insert_.push_back(value);
+    Heap::push(insert_.begin(), insert_.end(), value_compare());
+    purge();
+  }
+
+  /// @brief Moves the given element value to the priority queue.
+  /// @param value the value of the element to push
+  /// @see emplace()
+  /// @see pop()
+  void push(value_type&& value) {
+    insert_.push_back(std::move(value));
+    Heap::push(insert_.begin(), insert_.end(), value_compare());
+    purge();
+  }
+
+  /// @brief Pushes the given range of value to the priority queue.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of elements to push
+  /// @param last the end of the range of elements to push
+  /// @see emplace()
+  /// @see pop()
+  template <class InputIt>
+  void push(InputIt first, InputIt last) {
+    for (auto it = first; it != last; ++it) {
+      push(*it);
+    }
+  }
+
+  /// @brief Pushes a new element constructed in-place from `args` to the
+  /// priority queue.
+  /// @param args	arguments to forward to the constructor of the element
+  /// @see push()
+  /// @see pop()
+  template <class... Args>
+  void emplace(Args&&... args) {
+    insert_.emplace_back(std::forward<Args>(args)...);
+    Heap::push(insert_.begin(), insert_.end(), value_compare());
+    purge();
+  }
+
+  /// @brief Removes the top element from the priority queue.
+  /// @see emplace()
+  /// @see push()
+  /// @see top()
+  void pop() {
+    Heap::pop(insert_.begin(), insert_.end(), value_compare());
+    insert_.pop_back();
+    purge();
+  }
+
+  /// @brief Removes the top element from the priority queue and returns it.
+  /// Unlike a call to `top()` followed by `pop()`, moves the element out
+  /// instead of copying it.
+  /// @return The former top element
+  /// @see pop()
+  /// @see top()
+  [[nodiscard]] value_type extract_top() {
+    Heap::pop(insert_.begin(), insert_.end(), value_compare());
+    value_type value = std::move(insert_.back());
+    insert_.pop_back();
+    purge();
+    return value;
+  }
+
+  /// @brief Removes the element with the given key from the priority queue.
+  /// @param key the key of the element to remove
+  /// @see pop()
+  void erase(const key_type& key) {
+    remove_.push_back(key);
+    Heap::push(remove_.begin(), remove_.end(), comp_);
+    compact_if_needed();
+    purge();
+  }
+
+  /// @brief Removes the elements with the given range of keys from the
+  /// priority queue.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of keys to remove
+  /// @param last the end of the range of keys to remove
+  /// @see pop()
+  template <class InputIt>
+  void erase(InputIt first, InputIt last) {
+    for (auto it = first; it != last; ++it) {
+      erase(*it);
+    }
+  }
+
+  /// @brief Discards the elements with every removed key from the underlying
+  /// insert container, not only those that reached the top, and clears the
+  /// removed keys. Keys identify elements, so this is a sort of the removed
+  /// keys and a binary search per element, followed by `Heap::make`, in
+  /// O(n log m) time for n elements and m removed keys.
+  /// @see compaction_threshold()
+  void compact() {
+    std::sort(remove_.begin(), remove_.end(), comp_);
+    insert_.erase(std::remove_if(insert_.begin(), insert_.end(),
+                                 [this](const value_type& value) {
+                                   return std::binary_search(
+                                       remove_.cbegin(), remove_.cend(),
+                                       key_of_(value), comp_);
+                                 }),
+                  insert_.end());
+    remove_.clear();
+    Heap::make(insert_.begin(), insert_.end(), value_compare());
+  }
+
+  /// @brief Returns the current compaction threshold.
+  /// @return The ratio of removed keys to stored elements above which
+  /// `erase()` calls `compact()`, or zero if automatic compaction is
+  /// disabled.
+  /// @see compact()
+  [[nodiscard]] double compaction_threshold() const {
+    return compaction_threshold_;
+  }
+
+  /// @brief Enables automatic compaction: `erase()` calls `compact()` as soon
+  /// as more than `threshold` times as many keys are removed as elements are
+  /// stored, see `lazy_priority_queue::compaction_threshold()`.
+  /// @param threshold the ratio of removed keys to stored elements that
+  /// triggers compaction, e.g. `0.5`; zero disables automatic compaction
+  /// @see compact()
+  void compaction_threshold(double threshold) {
+    compaction_threshold_ = threshold;
+    compact_if_needed();
+  }
+
+  /// @brief Returns the key of the given element.
+  /// @param value the element to extract the key of
+  /// @return The key of `value` as extracted by `KeyOf`.
+  [[nodiscard]] key_type key_of(const value_type& value) const {
+    return key_of_(value);
+  }
+
+ private:
+  [[nodiscard]] auto value_compare() const {
+    return [this](const value_type& lhs, const value_type& rhs) {
+      return comp_(key_of_(lhs), key_of_(rhs));
+    };
+  }
+
+  void compact_if_needed() {
+    if (compaction_threshold_ > 0 &&
+        static_cast<double>(remove_.size()) >
+            compaction_threshold_ * static_cast<double>(insert_.size())) {
+      compact();
+    }
+  }
+
+  Compare comp_;
+  KeyOf key_of_;
+  Container insert_;
+  std::vector<key_type> remove_;
+  double compaction_threshold_{};
+};
\ No newline at end of file
@@ -0,0 +1,192 @@
+/**
+ * @file
+ * @brief Defines a lazy radix priority queue for monotone unsigned keys.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/// @brief A monotone priority queue of unsigned integral keys with implicit
+/// removals. Unlike `lazy_priority_queue`, the `top()` is always the smallest
+/// key, and every pushed or erased key must not be smaller than the last key
+/// returned by `top()`, as is the case for Dijkstra's algorithm and timer
+/// queues. Keys are distributed into buckets by the highest bit in which they
+/// differ from the last top, which gives amortized O(log C) operations, where
+/// C is the largest key, with mostly sequential memory access. Removed keys are
+/// kept in a second set of buckets and are annihilated once they reach the
+/// top, so the behavior is undefined if the key being removed was not present
+/// in the queue.
+/// @tparam Key The type of the stored keys, an unsigned integral type.
+/// @tparam Container The type of the underlying bucket containers. The
+/// container must satisfy the requirements of SequenceContainer and provide
+/// the following functions with the usual semantics:
+/// - back()
+/// - push_back()
+/// - pop_back().
+template <class Key, class Container = std::vector<Key>>
+class lazy_radix_priority_queue {
+  static_assert(std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+                "keys of a radix priority queue must be unsigned integers");
+
+ public:
+  using value_type = Key;
+  using size_type = typename Container::size_type;
+  using const_reference = const Key&;
+
+  /// @brief Default constructor. Value-initializes the underlying buckets.
+  lazy_radix_priority_queue() = default;
+
+  /// @brief Pushes every key from the `{first, last}` range.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of keys to initialize with
+  /// @param last the end of the range of keys to initialize with
+  template <class InputIt>
+  lazy_radix_priority_queue(InputIt first, InputIt last) {
+    push(first, last);
+  }
+
+  /// @brief Returns reference to the top key in the priority queue, which is
+  /// the smallest key in the queue. This key will be removed on a call to
+  /// `pop()`.
+  /// @return Reference to the smallest key
+  /// @see pop()
+  [[nodiscard]] const_reference top() const {
+    assert(!empty());
+    while (true) {
+      if (insert_[0].empty()) {
+        redistribute();
+      }
+      while (!insert_[0].empty() && !remove_[0].empty()) {
+        insert_[0].pop_back();
+        remove_[0].pop_back();
+        --insert_size_;
+        --remove_size_;
+      }
+      if (!insert_[0].empty()) {
+        return last_;
+      }
+    }
+  }
+
+  /// @brief Checks if the queue has no keys, i.e. whether every inserted key
+  /// has been removed
+  /// @return `true` if the queue is empty, `false` otherwise
+  /// @see size()
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  /// @brief Returns the number of keys in the queue, that is, the number of
+  /// inserted keys minus the number of removed keys
+  /// @return The number of keys in the queue.
+  /// @see empty()
+  [[nodiscard]] int size() const {
+    return static_cast<int>(insert_size_) - static_cast<int>(remove_size_);
+  }
+
+  /// @brief Pushes the given key to the priority queue. The behavior is
+  /// undefined if the key is smaller than the last `top()`.
+  /// @param key the value of the key to push
+  /// @see pop()
+  void push(Key key) {
+    assert(key >= last_);
+    insert_[bucket(key)].push_back(key);
+    ++insert_size_;
+  }
+
+  /// @brief Pushes the given range of keys to the priority queue.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of keys to push
+  /// @param last the end of the range of keys to push
+  /// @see pop()
+  template <class InputIt>
+  void push(InputIt first, InputIt last) {
+    for (auto it = first; it != last; ++it) {
+      push(*it);
+    }
+  }
+
+  /// @brief Removes the top key from the priority queue.
+  /// @see push()
+  /// @see top()
+  void pop() {
+    std::ignore = top();
+    insert_[0].pop_back();
+    --insert_size_;
+  }
+
+  /// @brief Removes the key from the priority queue.
+  /// @param key the value of the key to remove
+  /// @see pop()
+  void erase(Key key) {
+    assert(key >= last_);
+    remove_[bucket(key)].push_back(key);
+    ++remove_size_;
+  }
+
+  /// @brief Removes the given range of keys from the priority queue.
+  /// @tparam InputIt must meet the requirements of LegacyInputIterator.
+  /// @param first the beginning of the range of keys to remove
+  /// @param last the end of the range of keys to remove
+  /// @see pop()
+  template <class InputIt>
+  void erase(InputIt first, InputIt last) {
+    for (auto it = first; it != last; ++it) {
+      erase(*it);
+    }
+  }
+
+ private:
+  static constexpr std::size_t num_buckets =
+      std::numeric_limits<Key>::digits + 1;
+
+  /// @brief Returns the index of the bucket for `key`, that is, the position
+  /// of the highest bit in which `key` differs from the last top, or zero if
+  /// they are equal.
+  [[nodiscard]] std::size_t bucket(Key key) const {
+    const auto diff = static_cast<unsigned long long>(key ^ last_);
+#if defined(__GNUC__) || defined(__clang__)
+    return diff == 0 ? 0
+                     : std::numeric_limits<unsigned long long>::digits -
+                           __builtin_clzll(diff);
+#else
+    std::size_t width = 0;
+    for (auto rest = diff; rest != 0; rest >>= 1) {
+      ++width;
+    }
+    return width;
+#endif
+  }
+
+  /// @brief Advances the last top to the smallest inserted key and
+  /// redistributes the bucket it was found in. Every bucket below it is empty,
+  /// and every bucket above it keeps its keys. Pending removals are never
+  /// smaller than the smallest inserted key, so their bucket is redistributed
+  /// the same way.
+  void redistribute() const {
+    std::size_t index = 1;
+    while (insert_[index].empty()) {
+      ++index;
+    }
+    last_ = *std::min_element(insert_[index].begin(), insert_[index].end());
+    for (auto* buckets : {&insert_, &remove_}) {
+      auto& source = (*buckets)[index];
+      for (const auto& key : source) {
+        (*buckets)[bucket(key)].push_back(key);
+      }
+      source.clear();
+    }
+  }
+
+  mutable std::array<Container, num_buckets> insert_;
+  mutable std::array<Container, num_buckets> remove_;
+  mutable Key last_{};
+  mutable size_type insert_size_{};
+  mutable size_type remove_size_{};
+};
\ No newline at end of file
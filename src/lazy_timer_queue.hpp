@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @brief Defines a queue of cancellable timers on top of a lazy keyed priority
+ * queue.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "heap.hpp"
+#include "lazy_keyed_priority_queue.hpp"
+
+/// @brief A queue of timers, each firing a value once its deadline passes,
+/// that can be cancelled at any time before it fires. Cancellation is a lazy
+/// removal: it pushes the key of the timer to a second heap instead of
+/// searching for it, so it takes O(1) time on average for random deadlines
+/// and O(log n) at worst. Tombstones are compacted as soon as they make up a
+/// third of the stored entries, so memory stays proportional to the number of
+/// active timers even when most timers are cancelled.
+///
+/// Timers are ordered by deadline, then by the order they were scheduled in.
+/// The time passed to `pop_expired()` must not decrease, as with a steady
+/// clock. A timer scheduled with a deadline before the deadline of the last
+/// fired timer is scheduled at that deadline instead, so it fires on the next
+/// call to `pop_expired()` and the keys of fired timers never decrease.
+/// @tparam T The type of the values that timers fire.
+/// @tparam Clock The clock that deadlines refer to.
+/// @tparam Heap A heap policy that maintains the underlying containers, see
+/// `lazy_priority_queue`.
+template <class T, class Clock = std::chrono::steady_clock,
+          class Heap = binary_heap>
+class lazy_timer_queue {
+ public:
+  using value_type = T;
+  using time_point = typename Clock::time_point;
+
+  /// @brief Identifies a scheduled timer, to cancel it.
+  struct handle {
+    /// @brief The deadline the timer is scheduled at.
+    time_point deadline;
+    /// @brief The number of timers scheduled before this one.
+    std::uint64_t id;
+  };
+
+  /// @brief Constructs an empty timer queue.
+  lazy_timer_queue() { timers_.compaction_threshold(compaction_threshold); }
+
+  /// @brief Returns the deadline of the next timer to fire. The behavior is
+  /// undefined if the queue is empty.
+  [[nodiscard]] time_point next_deadline() const {
+    return timers_.top().key.first;
+  }
+
+  /// @brief Checks if no timer is active.
+  /// @see size()
+  [[nodiscard]] bool empty() const { return timers_.empty(); }
+
+  /// @brief Returns the number of active timers, scheduled but neither fired
+  /// nor cancelled.
+  /// @see empty()
+  [[nodiscard]] int size() const { return timers_.size(); }
+
+  /// @brief Schedules a timer that fires `value` at `deadline`.
+  /// @param deadline the time after which the timer fires
+  /// @param value the value to fire
+  /// @return The handle that cancels the timer.
+  /// @see cancel()
+  handle schedule(time_point deadline, value_type value) {
+    if (fired_any_) {
+      deadline = std::max(deadline, last_fired_.first);
+    }
+    const key_type key{deadline, next_id_++};
+    timers_.push(entry{key, std::move(value)});
+    return {key.first, key.second};
+  }
+
+  /// @brief Cancels the timer identified by `timer` unless it already fired.
+  /// The behavior is undefined if the timer was already cancelled.
+  /// @param timer the handle returned by `schedule()`
+  /// @return `true` if the timer was cancelled, `false` if it already fired
+  /// @see schedule()
+  bool cancel(const handle& timer) {
+    const key_type key{timer.deadline, timer.id};
+    if (fired_any_ && key <= last_fired_) {
+      return false;
+    }
+    timers_.erase(key);
+    return true;
+  }
+
+  /// @brief Fires every timer whose deadline is not after `now`, in order of
+  /// deadline, by moving their values to `out`.
+  /// @tparam OutputIt must meet the requirements of LegacyOutputIterator.
+  /// @param now the current time, not before the one of the previous call
+  /// @param out the beginning of the destination range
+  /// @return Output iterator to the element past the last fired value.
+  template <class OutputIt>
+  OutputIt pop_expired(time_point now, OutputIt out) {
+    while (!timers_.empty() && timers_.top().key.first <= now) {
+      auto timer = timers_.extract_top();
+      last_fired_ = timer.key;
+      fired_any_ = true;
+      *out = std::move(timer.value);
+      ++out;
+    }
+    return out;
+  }
+
+ private:
+  using key_type = std::pair<time_point, std::uint64_t>;
+
+  struct entry {
+    key_type key;
+    value_type value;
+  };
+
+  struct key_of {
+    const key_type& operator()(const entry& timer) const { return timer.key; }
+  };
+
+  // Tombstones make up at most a third of the stored entries
+  static constexpr double compaction_threshold = 0.5;
+
+  lazy_keyed_priority_queue<entry, key_of, std::vector<entry>,
+                            std::greater<key_type>, Heap>
+      timers_;
+  key_type last_fired_{};
+  bool fired_any_{};
+  std::uint64_t next_id_{};
+};
\ No newline at end of file
@@ -1,9 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <istream>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
 #include <queue>
-#include <tuple>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 
+#include "heap.hpp"
+#include "stats.hpp"
+
+/// @brief The order in which a lazy priority queue writes out its elements
+/// when drained or copied at once.
+enum class sort_order {
+  /// @brief Ascending with respect to `Compare`, i.e. the top element last.
+  ascending,
+  /// @brief Descending with respect to `Compare`, i.e. the top element
+  /// first, as if the elements were popped one by one.
+  descending,
+};
+
+/// @brief The header of a lazy priority queue snapshot, see
+/// `lazy_priority_queue::serialize()`. It is followed by the raw insert heap
+/// and the raw remove heap, all in host byte order, so a snapshot written on a
+/// host with a different byte order is rejected by its magic number.
+struct lazy_priority_queue_snapshot_header {
+  /// @brief Identifies snapshots, "LPQS" in little-endian order.
+  static constexpr std::uint32_t expected_magic = 0x5351504C;
+  /// @brief The version of the format described by this header.
+  static constexpr std::uint32_t current_version = 2;
+
+  std::uint32_t magic = expected_magic;
+  std::uint32_t version = current_version;
+  std::uint64_t value_size{};
+  /// @brief The arity of the heap policy, or zero if it does not declare one.
+  std::uint64_t heap_arity{};
+  std::uint64_t insert_size{};
+  std::uint64_t remove_size{};
+  double compaction_threshold{};
+};
+
 /// @brief A priority queue is a container adaptor that provides constant time
 /// lookup of the largest (by default) element, at the expense of logarithmic
 /// insertion and extraction. A user-provided `Compare` can be supplied to
@@ -30,11 +73,21 @@
 /// that "come before" are actually output last. That is, the front of the
 /// queue contains the "last" element according to the weak ordering imposed
 /// by Compare.
+/// @tparam Heap A heap policy that maintains both underlying containers, e.g.
+/// `binary_heap` (the default) or `d_ary_heap<4>`. A wider heap is shallower,
+/// which reduces cache misses in `pop()` and `top()` on large queues. A policy
+/// provides static `push`, `pop` and `make` functions, and `replace_top` if
+/// `update()` is used.
+/// @tparam Stats A statistics policy, e.g. `no_stats` (the default), which
+/// compiles to nothing, or `counting_stats`, whose counters are returned by
+/// `stats()`.
 template <class T, class Container = std::vector<T>,
-          class Compare = std::less<typename Container::value_type>>
-class lazy_priority_queue {
+          class Compare = std::less<typename Container::value_type>,
+          class Heap = binary_heap, class Stats = no_stats>
+class lazy_priority_queue : private Stats {
  public:
   using value_type = typename Container::value_type;
+  using size_type = typename Container::size_type;
   using const_reference = typename Container::const_reference;
 
   /// @brief Default constructor. Value-initializes the comparator and the
@@ -50,31 +103,33 @@ class lazy_priority_queue {
 
   /// @brief Copy-constructs the underlying insert container from `cont`.
   /// Value-initializes the underlying remove container. Copy-constructs the
-  /// comparison functor from `compare`. Calls `std::make_heap`.
+  /// comparison functor from `compare`. Calls `Heap::make`.
   /// @param compare the comparison function object to initialize the
   /// underlying comparison functor
   /// @param cont container to be used as source to initialize the underlying
   /// insert container
   explicit lazy_priority_queue(const Compare& compare, const Container& cont)
       : comp_(compare), insert_(cont), remove_(Container()) {
-    std::make_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::make(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(insert_.size(), insert_.size());
   }
 
   /// @brief Move-constructs the underlying insert container with
   /// `std::move(cont)`. Value-initializes the underlying remove container.
   /// Copy-constructs the comparison functor with `compare`. Calls
-  /// `std::make_heap`.
+  /// `Heap::make`.
   /// @param compare the comparison function object to initialize the
   /// underlying comparison functor
   /// @param cont container to be used as source to initialize the underlying
   /// insert container
   lazy_priority_queue(const Compare& compare, Container&& cont)
       : comp_(compare), insert_(std::move(cont)), remove_(Container()) {
-    std::make_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::make(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(insert_.size(), insert_.size());
   }
 
   /// @brief Constructs the underlying container from the `{first, last}` range
-  /// and the comparator from `compare`. Calls `std::make_heap`.
+  /// and the comparator from `compare`. Calls `Heap::make`.
   /// @tparam InputIt must meet the requirements of LegacyInputIterator.
   /// @param first the beginning of the range of elements to initialize with
   /// @param last the end of the range of elements to initialize with
@@ -84,14 +139,15 @@ class lazy_priority_queue {
   lazy_priority_queue(InputIt first, InputIt last,
                       const Compare& compare = Compare())
       : comp_(compare), insert_(first, last), remove_(Container()) {
-    std::make_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::make(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(insert_.size(), insert_.size());
   }
 
   /// @brief Copy-constructs the underlying insert container from `cont`.
   /// Value-initializes the underlying remove container. Copy-constructs the
   /// comparison functor from `compare`. Then inserts all elements from the
   /// `{first, last}` range into the insert container. Finally calls
-  /// `std::make_heap`.
+  /// `Heap::make`.
   /// @tparam InputIt must meet the requirements of LegacyInputIterator.
   /// @param first the beginning of the range of elements to initialize with
   /// @param last the end of the range of elements to initialize with
@@ -104,13 +160,14 @@ class lazy_priority_queue {
                       const Container& cont)
       : comp_(compare), insert_(cont), remove_(Container()) {
     insert_.insert(insert_.end(), first, last);
-    std::make_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::make(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(insert_.size(), insert_.size());
   }
 
   /// @brief Move-constructs the underlying insert container with
   /// `std::move(cont)`. Copy-constructs the comparison functor from
   /// `compare`. Then inserts all elements from the `{first, last}` range into
-  /// the insert container. Finally calls `std::make_heap`.
+  /// the insert container. Finally calls `Heap::make`.
   /// @tparam InputIt must meet the requirements of LegacyInputIterator.
   /// @param first the beginning of the range of elements to initialize with
   /// @param last the end of the range of elements to initialize with
@@ -123,24 +180,128 @@ class lazy_priority_queue {
                       Container&& cont)
       : comp_(compare), insert_(std::move(cont)), remove_(Container()) {
     insert_.insert(insert_.end(), first, last);
-    std::make_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::make(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(insert_.size(), insert_.size());
   }
 
+  /// @brief Constructs both underlying containers with `alloc` as their
+  /// allocator. Value-initializes the comparator. This overload participates
+  /// in overload resolution only if `std::uses_allocator<Container,
+  /// Alloc>::value` is `true`.
+  /// @tparam Alloc an allocator type, or e.g. a `std::pmr::memory_resource*`
+  /// for `std::pmr` containers
+  /// @param alloc allocator to use for all memory allocations of the
+  /// underlying containers
+  template <class Alloc, class = std::enable_if_t<
+                             std::uses_allocator_v<Container, Alloc>>>
+  explicit lazy_priority_queue(const Alloc& alloc)
+      : comp_(), insert_(alloc), remove_(alloc) {}
+
+  /// @brief Constructs both underlying containers with `alloc` as their
+  /// allocator. Copy-constructs the comparison functor from `compare`.
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  /// @param alloc allocator to use for all memory allocations of the
+  /// underlying containers
+  template <class Alloc, class = std::enable_if_t<
+                             std::uses_allocator_v<Container, Alloc>>>
+  lazy_priority_queue(const Compare& compare, const Alloc& alloc)
+      : comp_(compare), insert_(alloc), remove_(alloc) {}
+
+  /// @brief Copy-constructs the underlying insert container from `cont` and
+  /// constructs the underlying remove container, both with `alloc` as their
+  /// allocator. Copy-constructs the comparison functor from `compare`. Calls
+  /// `Heap::make`.
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  /// @param cont container to be used as source to initialize the underlying
+  /// insert container
+  /// @param alloc allocator to use for all memory allocations of the
+  /// underlying containers
+  template <class Alloc, class = std::enable_if_t<
+                             std::uses_allocator_v<Container, Alloc>>>
+  lazy_priority_queue(const Compare& compare, const Container& cont,
+                      const Alloc& alloc)
+      : comp_(compare), insert_(cont, alloc), remove_(alloc) {
+    Heap::make(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(insert_.size(), insert_.size());
+  }
+
+  /// @brief Move-constructs the underlying insert container from `cont` and
+  /// constructs the underlying remove container, both with `alloc` as their
+  /// allocator. Copy-constructs the comparison functor from `compare`. Calls
+  /// `Heap::make`.
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  /// @param cont container to be used as source to initialize the underlying
+  /// insert container
+  /// @param alloc allocator to use for all memory allocations of the
+  /// underlying containers
+  template <class Alloc, class = std::enable_if_t<
+                             std::uses_allocator_v<Container, Alloc>>>
+  lazy_priority_queue(const Compare& compare, Container&& cont,
+                      const Alloc& alloc)
+      : comp_(compare), insert_(std::move(cont), alloc), remove_(alloc) {
+    Heap::make(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(insert_.size(), insert_.size());
+  }
+
+  /// @brief Copy-constructs the queue from `other`, using `alloc` as the
+  /// allocator of both underlying containers.
+  /// @param other another lazy priority queue to be used as source
+  /// @param alloc allocator to use for all memory allocations of the
+  /// underlying containers
+  template <class Alloc, class = std::enable_if_t<
+                             std::uses_allocator_v<Container, Alloc>>>
+  lazy_priority_queue(const lazy_priority_queue& other, const Alloc& alloc)
+      : Stats(other),
+        comp_(other.comp_),
+        insert_(other.insert_, alloc),
+        remove_(other.remove_, alloc),
+        compaction_threshold_(other.compaction_threshold_) {}
+
+  /// @brief Move-constructs the queue from `other`, using `alloc` as the
+  /// allocator of both underlying containers.
+  /// @param other another lazy priority queue to be used as source
+  /// @param alloc allocator to use for all memory allocations of the
+  /// underlying containers
+  template <class Alloc, class = std::enable_if_t<
+                             std::uses_allocator_v<Container, Alloc>>>
+  lazy_priority_queue(lazy_priority_queue&& other, const Alloc& alloc)
+      : Stats(std::move(other)),
+        comp_(std::move(other.comp_)),
+        insert_(std::move(other.insert_), alloc),
+        remove_(std::move(other.remove_), alloc),
+        compaction_threshold_(other.compaction_threshold_) {}
+
   /// @brief Returns reference to the top element in the priority queue. This
   /// element will be removed on a call to `pop()`. If default comparison
   /// function is used, the returned element is also the greatest among the
-  /// elements in the queue.
+  /// elements in the queue. Every modifier purges removed elements from the
+  /// top, so this function does not modify the queue and may be called
+  /// concurrently with other `const` member functions.
   /// @return Reference to the top element as if obtained by a call to
   /// `insert_.front()`
   /// @see pop()
-  [[nodiscard]] const_reference top() const {
-    while (!remove_.empty() && remove_.front() == insert_.front()) {
-      std::pop_heap(insert_.begin(), insert_.end(), comp_);
+  /// @see purge()
+  [[nodiscard]] const_reference top() const { return insert_.front(); }
+
+  /// @brief Discards removed elements from the top of the queue until the top
+  /// element has not been removed. Every modifier calls this function before
+  /// returning, so calling it again has no effect.
+  /// @see top()
+  /// @see compact()
+  void purge() {
+    size_type annihilations = 0;
+    while (!insert_.empty() && !remove_.empty() &&
+           remove_.front() == insert_.front()) {
+      Heap::pop(insert_.begin(), insert_.end(), comp_);
       insert_.pop_back();
-      std::pop_heap(remove_.begin(), remove_.end(), comp_);
+      Heap::pop(remove_.begin(), remove_.end(), comp_);
       remove_.pop_back();
+      ++annihilations;
     }
-    return insert_.front();
+    Stats::purged(annihilations);
   }
 
   /// @brief Checks if the underlying containers have no elements, i.e. whether
@@ -163,7 +324,9 @@ class lazy_priority_queue {
   /// @see pop()
   void push(const value_type& value) {
     insert_.push_back(value);
-    std::push_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::push(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(1, insert_.size());
+    purge();
   }
 
   /// @brief Moves the given element value to the priority queue.
@@ -172,10 +335,14 @@ class lazy_priority_queue {
   /// @see pop()
   void push(value_type&& value) {
     insert_.push_back(std::move(value));
-    std::push_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::push(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(1, insert_.size());
+    purge();
   }
 
-  /// @brief Pushes the given range of value to the priority queue.
+  /// @brief Pushes the given range of value to the priority queue. Appends
+  /// the whole range at once, then either sifts up every new element or
+  /// rebuilds the heap in linear time, whichever is estimated to be cheaper.
   /// @tparam InputIt must meet the requirements of LegacyInputIterator.
   /// @param first the beginning of the range of elements to push
   /// @param last the end of the range of elements to push
@@ -183,9 +350,54 @@ class lazy_priority_queue {
   /// @see pop()
   template <class InputIt>
   void push(InputIt first, InputIt last) {
-    for (auto it = first; it != last; ++it) {
-      push(*it);
+    const auto heap_size = insert_.size();
+    insert_.insert(insert_.end(), first, last);
+    restore_heap(insert_, heap_size);
+    Stats::pushed(insert_.size() - heap_size, insert_.size());
+    purge();
+  }
+
+  /// @brief Replaces an element of the priority queue with another one, e.g.
+  /// to change its priority. If `old_value` is the top element, it is
+  /// overwritten and sifted down in place, otherwise it is erased and
+  /// `new_value` is pushed. The behavior is undefined if `old_value` is not
+  /// present in the queue.
+  /// @param old_value the value of the element to replace
+  /// @param new_value the value to replace it with
+  /// @see erase()
+  /// @see push()
+  void update(const value_type& old_value, const value_type& new_value) {
+    if (insert_.front() == old_value) {
+      insert_.front() = new_value;
+      Heap::replace_top(insert_.begin(), insert_.end(), comp_);
+      purge();
+    } else {
+      erase(old_value);
+      push(new_value);
+    }
+  }
+
+  /// @brief Moves every element and every pending removal of `other` into
+  /// this queue and leaves `other` empty. The smaller of the two insert
+  /// containers is appended to the larger one, and the heap is restored as
+  /// in `push(first, last)`, which takes O(n) time at worst. The remove
+  /// containers are merged the same way. Merging a queue into itself has no
+  /// effect. The behavior is undefined if `other` orders elements
+  /// differently.
+  /// @param other the queue to merge into this one
+  /// @see push()
+  void merge(lazy_priority_queue&& other) {
+    if (this == &other) {
+      return;
     }
+    const auto num_insertions = other.insert_.size();
+    const auto num_removals = other.remove_.size();
+    meld(insert_, other.insert_);
+    meld(remove_, other.remove_);
+    Stats::pushed(num_insertions, insert_.size());
+    Stats::erased(num_removals, remove_.size());
+    compact_if_needed();
+    purge();
   }
 
   /// @brief Removes the top element from the priority queue.
@@ -193,9 +405,23 @@ class lazy_priority_queue {
   /// @see push()
   /// @see top()
   void pop() {
-    std::ignore = top();
-    std::pop_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::pop(insert_.begin(), insert_.end(), comp_);
     insert_.pop_back();
+    purge();
+  }
+
+  /// @brief Removes the top element from the priority queue and returns it.
+  /// Unlike a call to `top()` followed by `pop()`, moves the element out
+  /// instead of copying it.
+  /// @return The former top element
+  /// @see pop()
+  /// @see top()
+  [[nodiscard]] value_type extract_top() {
+    Heap::pop(insert_.begin(), insert_.end(), comp_);
+    value_type value = std::move(insert_.back());
+    insert_.pop_back();
+    purge();
+    return value;
   }
 
   /// @brief Removes the value from the priority queue.
@@ -203,7 +429,10 @@ class lazy_priority_queue {
   /// @see pop()
   void erase(const value_type& value) {
     remove_.push_back(value);
-    std::push_heap(remove_.begin(), remove_.end(), comp_);
+    Heap::push(remove_.begin(), remove_.end(), comp_);
+    Stats::erased(1, remove_.size());
+    compact_if_needed();
+    purge();
   }
 
   /// @brief Removes the value from the priority queue.
@@ -211,19 +440,224 @@ class lazy_priority_queue {
   /// @see pop()
   void erase(value_type&& value) {
     remove_.push_back(std::move(value));
-    std::push_heap(remove_.begin(), remove_.end(), comp_);
+    Heap::push(remove_.begin(), remove_.end(), comp_);
+    Stats::erased(1, remove_.size());
+    compact_if_needed();
+    purge();
   }
 
-  /// @brief Removes the given range of value from the priority queue.
+  /// @brief Removes the given range of value from the priority queue. Appends
+  /// the whole range at once, then either sifts up every new element or
+  /// rebuilds the heap in linear time, whichever is estimated to be cheaper.
   /// @tparam InputIt must meet the requirements of LegacyInputIterator.
   /// @param first the beginning of the range of elements to remove
   /// @param last the end of the range of elements to remove
   /// @see pop()
   template <class InputIt>
   void erase(InputIt first, InputIt last) {
-    for (auto it = first; it != last; ++it) {
-      erase(*it);
+    const auto heap_size = remove_.size();
+    remove_.insert(remove_.end(), first, last);
+    restore_heap(remove_, heap_size);
+    Stats::erased(remove_.size() - heap_size, remove_.size());
+    compact_if_needed();
+    purge();
+  }
+
+  /// @brief Reserves storage in the underlying containers, so that the given
+  /// numbers of insertions and removals do not reallocate them. Available
+  /// only if `Container` provides `reserve()`, e.g. for `std::vector`.
+  /// @param num_insertions the number of elements to reserve in the insert
+  /// container
+  /// @param num_removals the number of elements to reserve in the remove
+  /// container
+  /// @see shrink_to_fit()
+  void reserve(size_type num_insertions, size_type num_removals = 0) {
+    insert_.reserve(num_insertions);
+    remove_.reserve(num_removals);
+  }
+
+  /// @brief Requests the removal of unused capacity from both underlying
+  /// containers. Calling `compact()` first also releases the memory held by
+  /// removed elements.
+  /// @see reserve()
+  void shrink_to_fit() {
+    insert_.shrink_to_fit();
+    remove_.shrink_to_fit();
+  }
+
+  /// @brief Discards every removed element from both underlying containers,
+  /// not only those that reached the top. Sorts both containers, annihilates
+  /// equal pairs of inserted and removed values, and rebuilds both heaps in
+  /// O(n log n) time.
+  /// @see compaction_threshold()
+  void compact() {
+    const auto num_removals = remove_.size();
+    annihilate(insert_, remove_);
+    Heap::make(insert_.begin(), insert_.end(), comp_);
+    Heap::make(remove_.begin(), remove_.end(), comp_);
+    Stats::compacted(num_removals - remove_.size());
+    purge();
+  }
+
+  /// @brief Moves every element out of the queue to `out` in sorted order
+  /// and leaves the queue empty. Instead of popping the elements one by one,
+  /// sorts both underlying containers and computes their multiset difference
+  /// in a single linear pass, see `compact()`.
+  /// @tparam OutputIt must meet the requirements of LegacyOutputIterator.
+  /// @param out the beginning of the destination range
+  /// @param order `sort_order::descending` writes the elements in the order
+  /// repeated calls to `pop()` would remove them, `sort_order::ascending` in
+  /// the reverse order
+  /// @return Output iterator to the element past the last element written
+  /// @see sorted_snapshot()
+  template <class OutputIt>
+  OutputIt drain_sorted(OutputIt out,
+                        sort_order order = sort_order::descending) {
+    annihilate(insert_, remove_);
+    out = move_sorted(insert_, out, order);
+    insert_.clear();
+    remove_.clear();
+    return out;
+  }
+
+  /// @brief Copies every element of the queue to `out` in sorted order
+  /// without modifying the queue. Works on copies of both underlying
+  /// containers the same way as `drain_sorted()`.
+  /// @tparam OutputIt must meet the requirements of LegacyOutputIterator.
+  /// @param out the beginning of the destination range
+  /// @param order the order to write the elements in, see `drain_sorted()`
+  /// @return Output iterator to the element past the last element written
+  /// @see drain_sorted()
+  template <class OutputIt>
+  OutputIt sorted_snapshot(OutputIt out,
+                           sort_order order = sort_order::descending) const {
+    Container insert(insert_);
+    Container remove(remove_);
+    annihilate(insert, remove);
+    return move_sorted(insert, out, order);
+  }
+
+  /// @brief Returns the current compaction threshold.
+  /// @return The ratio of removed to inserted elements above which `erase()`
+  /// calls `compact()`, or zero if automatic compaction is disabled.
+  /// @see compact()
+  [[nodiscard]] double compaction_threshold() const {
+    return compaction_threshold_;
+  }
+
+  /// @brief Enables automatic compaction: `erase()` calls `compact()` as soon
+  /// as the remove container holds more than `threshold` times as many
+  /// elements as the insert container. This bounds the memory held by
+  /// erased elements that never reach the top. Amortized over the erasures
+  /// that trigger it, compaction costs O(log n / threshold) per erasure.
+  /// @param threshold the ratio of removed to inserted elements that triggers
+  /// compaction, e.g. `0.5`; zero disables automatic compaction
+  /// @see compact()
+  void compaction_threshold(double threshold) {
+    compaction_threshold_ = threshold;
+    compact_if_needed();
+  }
+
+  /// @brief Returns the statistics collected by the `Stats` policy, which are
+  /// all zero for `no_stats`.
+  /// @return A snapshot of the collected statistics
+  [[nodiscard]] lazy_priority_queue_stats stats() const {
+    return Stats::snapshot();
+  }
+
+  /// @brief Writes a snapshot of the queue to `out`: a
+  /// `lazy_priority_queue_snapshot_header` followed by both underlying
+  /// containers as raw arrays in heap order, so that `deserialize()` restores
+  /// the queue without rebuilding either heap. Requires a trivially copyable
+  /// `value_type` and a container with contiguous storage, such as
+  /// `std::vector`.
+  /// @param out the binary stream to write the snapshot to
+  /// @param compact_first whether to call `compact()` first, so that the
+  /// snapshot holds no removed elements
+  /// @throws std::runtime_error if the stream cannot be written
+  /// @see deserialize()
+  void serialize(std::ostream& out, bool compact_first = false) {
+    static_assert(std::is_trivially_copyable_v<value_type>,
+                  "snapshots store elements as raw bytes");
+    if (compact_first) {
+      compact();
+    }
+    lazy_priority_queue_snapshot_header header;
+    header.value_size = sizeof(value_type);
+    header.heap_arity = heap_arity();
+    header.insert_size = insert_.size();
+    header.remove_size = remove_.size();
+    header.compaction_threshold = compaction_threshold_;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_raw(out, insert_);
+    write_raw(out, remove_);
+    if (!out) {
+      throw std::runtime_error("cannot write lazy priority queue snapshot");
+    }
+  }
+
+  /// @brief Restores a queue from a snapshot written by `serialize()` without
+  /// heap construction, so that restoring is bound by I/O. A seekable stream
+  /// is checked to hold every element before a single read per underlying
+  /// container; other streams are read in bounded chunks, so a corrupt
+  /// header never allocates more than the stream holds plus one chunk. The
+  /// arity of `Heap` must match the one recorded in the snapshot. The
+  /// snapshot must also have been written with the same `Compare`, otherwise
+  /// the heaps are invalid and the behavior is undefined.
+  /// @param in the binary stream to read the snapshot from
+  /// @param compare the comparison function object to initialize the
+  /// underlying comparison functor
+  /// @return The restored queue, with the compaction threshold of the
+  /// serialized one
+  /// @throws std::runtime_error if the stream does not hold a snapshot of the
+  /// current version for elements of this size and a heap of this arity, or
+  /// is truncated
+  /// @see serialize()
+  [[nodiscard]] static lazy_priority_queue deserialize(
+      std::istream& in, const Compare& compare = Compare()) {
+    static_assert(std::is_trivially_copyable_v<value_type>,
+                  "snapshots store elements as raw bytes");
+    lazy_priority_queue_snapshot_header header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (in.gcount() != sizeof(header) ||
+        header.magic != lazy_priority_queue_snapshot_header::expected_magic) {
+      throw std::runtime_error("not a lazy priority queue snapshot");
+    }
+    if (header.version !=
+        lazy_priority_queue_snapshot_header::current_version) {
+      throw std::runtime_error(
+          "unsupported lazy priority queue snapshot version " +
+          std::to_string(header.version));
+    }
+    if (header.value_size != sizeof(value_type)) {
+      throw std::runtime_error(
+          "lazy priority queue snapshot of elements of size " +
+          std::to_string(header.value_size));
+    }
+    if (header.heap_arity != heap_arity()) {
+      throw std::runtime_error(
+          "lazy priority queue snapshot of a heap of arity " +
+          std::to_string(header.heap_arity));
+    }
+    // Without the length of the stream, reads chunks of about 16 MiB
+    auto chunk_size = std::max<std::uint64_t>(
+        (std::uint64_t{1} << 24) / sizeof(value_type), 1);
+    if (const auto remaining = remaining_bytes(in); remaining >= 0) {
+      const auto capacity =
+          static_cast<std::uint64_t>(remaining) / sizeof(value_type);
+      if (header.insert_size > capacity ||
+          header.remove_size > capacity - header.insert_size) {
+        throw std::runtime_error("truncated lazy priority queue snapshot");
+      }
+      chunk_size = std::max<std::uint64_t>(capacity, 1);
     }
+    lazy_priority_queue queue(compare);
+    read_raw(in, queue.insert_, header.insert_size, chunk_size);
+    read_raw(in, queue.remove_, header.remove_size, chunk_size);
+    queue.compaction_threshold_ = header.compaction_threshold;
+    queue.Stats::pushed(queue.insert_.size(), queue.insert_.size());
+    queue.Stats::erased(queue.remove_.size(), queue.remove_.size());
+    return queue;
   }
 
   /// @brief Pushes a new element to the priority queue. The element is
@@ -236,13 +670,201 @@ class lazy_priority_queue {
   template <class... Args>
   void emplace(Args&&... args) {
     insert_.emplace_back(std::forward<Args>(args)...);
-    std::push_heap(insert_.begin(), insert_.end(), comp_);
+    Heap::push(insert_.begin(), insert_.end(), comp_);
+    Stats::pushed(1, insert_.size());
+    purge();
   }
 
  private:
+  /// @brief Sorts both containers and discards every pair of an inserted and
+  /// a removed value that are equal, in O(n log n) time. The values that are
+  /// kept stay sorted.
+  void annihilate(Container& insert, Container& remove) const {
+    std::sort(insert.begin(), insert.end(), comp_);
+    std::sort(remove.begin(), remove.end(), comp_);
+
+    auto insert_kept = insert.begin();
+    auto keep_insert = [&insert_kept](auto it) {
+      if (insert_kept != it) {
+        *insert_kept = std::move(*it);
+      }
+      ++insert_kept;
+    };
+    auto remove_kept = remove.begin();
+
+    auto insert_it = insert.begin();
+    auto remove_it = remove.begin();
+    while (remove_it != remove.end()) {
+      for (; insert_it != insert.end() && comp_(*insert_it, *remove_it);
+           ++insert_it) {
+        keep_insert(insert_it);
+      }
+
+      // Equivalent values are annihilated only if they are also equal
+      const auto is_greater = [this, &remove_it](auto&& value) {
+        return comp_(*remove_it, value);
+      };
+      const auto insert_last =
+          std::find_if(insert_it, insert.end(), is_greater);
+      const auto remove_last =
+          std::find_if(remove_it, remove.end(), is_greater);
+      auto insert_live = insert_last;
+      for (; remove_it != remove_last; ++remove_it) {
+        const auto match = std::find(insert_it, insert_live, *remove_it);
+        if (match != insert_live) {
+          std::iter_swap(match, --insert_live);
+        } else {
+          if (remove_kept != remove_it) {
+            *remove_kept = std::move(*remove_it);
+          }
+          ++remove_kept;
+        }
+      }
+      for (; insert_it != insert_live; ++insert_it) {
+        keep_insert(insert_it);
+      }
+      insert_it = insert_last;
+    }
+    for (; insert_it != insert.end(); ++insert_it) {
+      keep_insert(insert_it);
+    }
+
+    insert.erase(insert_kept, insert.end());
+    remove.erase(remove_kept, remove.end());
+  }
+
+  /// @brief Writes the elements of `container` to `out` as raw bytes.
+  static void write_raw(std::ostream& out, const Container& container) {
+    out.write(
+        reinterpret_cast<const char*>(container.data()),
+        static_cast<std::streamsize>(container.size() * sizeof(value_type)));
+  }
+
+  /// @brief Returns the arity of `Heap`, or zero if it does not declare one.
+  static constexpr std::uint64_t heap_arity() {
+    if constexpr (has_arity<Heap>::value) {
+      return Heap::arity;
+    } else {
+      return 0;
+    }
+  }
+
+  template <class H, class = void>
+  struct has_arity : std::false_type {};
+  template <class H>
+  struct has_arity<H, std::void_t<decltype(H::arity)>> : std::true_type {};
+
+  /// @brief Returns the number of bytes left in `in`, or -1 if the stream is
+  /// not seekable.
+  static std::streamoff remaining_bytes(std::istream& in) {
+    const auto position = in.tellg();
+    if (position == std::streampos(-1)) {
+      return -1;
+    }
+    in.seekg(0, std::ios::end);
+    const auto end = in.tellg();
+    in.clear();
+    in.seekg(position);
+    return end == std::streampos(-1) ? -1 : end - position;
+  }
+
+  /// @brief Replaces the contents of `container` with `size` elements read
+  /// from `in` as raw bytes, at most `chunk_size` of them at a time, so that
+  /// the container only grows as far as the stream holds elements.
+  static void read_raw(std::istream& in, Container& container,
+                       std::uint64_t size, std::uint64_t chunk_size) {
+    container.clear();
+    while (container.size() < size) {
+      const auto offset = container.size();
+      const auto count = std::min<std::uint64_t>(size - offset, chunk_size);
+      container.resize(offset + static_cast<size_type>(count));
+      const auto bytes =
+          static_cast<std::streamsize>(count * sizeof(value_type));
+      in.read(reinterpret_cast<char*>(container.data() + offset), bytes);
+      if (in.gcount() != bytes) {
+        throw std::runtime_error("truncated lazy priority queue snapshot");
+      }
+    }
+  }
+
+  /// @brief Moves the elements of the sorted `container` to `out` in the
+  /// given order.
+  template <class OutputIt>
+  static OutputIt move_sorted(Container& container, OutputIt out,
+                              sort_order order) {
+    if (order == sort_order::ascending) {
+      return std::move(container.begin(), container.end(), out);
+    }
+    return std::move(container.rbegin(), container.rend(), out);
+  }
+
+  /// @brief Restores the heap property of `container` after elements were
+  /// appended to a heap of `heap_size` elements. Sifting up k new elements
+  /// costs O(k log_d n) in a d-ary heap while rebuilding costs O(n), so the
+  /// heap is rebuilt once k log_d n exceeds n. A heap policy without an
+  /// `arity` is assumed to be binary.
+  void restore_heap(Container& container, size_type heap_size) const {
+    constexpr size_type arity = heap_arity() != 0 ? heap_arity() : 2;
+    const auto size = container.size();
+    size_type depth = 0;
+    for (auto level_size = size; level_size > 1; level_size /= arity) {
+      ++depth;
+    }
+    if ((size - heap_size) * depth > size) {
+      Heap::make(container.begin(), container.end(), comp_);
+    } else {
+      for (auto last = std::next(container.begin(), heap_size);
+           last != container.end();) {
+        Heap::push(container.begin(), ++last, comp_);
+      }
+    }
+  }
+
+  /// @brief Moves the heap `source` to the end of the heap `target` and
+  /// restores the heap property, after swapping the two if `source` is larger
+  /// and swapping does not copy elements. Leaves `source` empty.
+  void meld(Container& target, Container& source) const {
+    if (source.size() > target.size() && swaps_storage(target, source)) {
+      target.swap(source);
+    }
+    const auto heap_size = target.size();
+    target.insert(target.end(), std::make_move_iterator(source.begin()),
+                  std::make_move_iterator(source.end()));
+    source.clear();
+    restore_heap(target, heap_size);
+  }
+
+  template <class C, class = void>
+  struct has_allocator : std::false_type {};
+  template <class C>
+  struct has_allocator<C, std::void_t<typename C::allocator_type>>
+      : std::true_type {};
+
+  /// @brief Returns whether swapping the containers exchanges their storage,
+  /// which is the case unless their allocators differ and do not propagate.
+  static bool swaps_storage(const Container& lhs, const Container& rhs) {
+    if constexpr (has_allocator<Container>::value) {
+      using traits =
+          std::allocator_traits<typename Container::allocator_type>;
+      return traits::propagate_on_container_swap::value ||
+             lhs.get_allocator() == rhs.get_allocator();
+    } else {
+      return true;
+    }
+  }
+
+  void compact_if_needed() {
+    if (compaction_threshold_ > 0 &&
+        static_cast<double>(remove_.size()) >
+            compaction_threshold_ * static_cast<double>(insert_.size())) {
+      compact();
+    }
+  }
+
   Compare comp_;
-  mutable Container insert_;
-  mutable Container remove_;
+  Container insert_;
+  Container remove_;
+  double compaction_threshold_{};
 };
 
 template <class Comp, class Container>
@@ -256,4 +878,21 @@ template <
         std::vector<typename std::iterator_traits<InputIt>::value_type>>
 lazy_priority_queue(InputIt, InputIt, Comp = Comp(), Container = Container())
     -> lazy_priority_queue<typename std::iterator_traits<InputIt>::value_type,
-                           Container, Comp>;
\ No newline at end of file
+                           Container, Comp>;
+
+namespace std {
+template <class T, class Container, class Compare, class Heap, class Stats,
+          class Alloc>
+struct uses_allocator<lazy_priority_queue<T, Container, Compare, Heap, Stats>,
+                      Alloc> : uses_allocator<Container, Alloc>::type {};
+}  // namespace std
+
+namespace pmr {
+/// @brief A lazy priority queue whose underlying containers allocate from a
+/// `std::pmr::memory_resource`, e.g. a `std::pmr::monotonic_buffer_resource`
+/// for short-lived queues.
+template <class T, class Compare = std::less<T>, class Heap = binary_heap,
+          class Stats = no_stats>
+using lazy_priority_queue =
+    ::lazy_priority_queue<T, std::pmr::vector<T>, Compare, Heap, Stats>;
+}  // namespace pmr
\ No newline at end of file
@@ -1,12 +1,19 @@
 /**
  * @file
- * @brief Defines a utility function to generate random set difference queries.
+ * @brief Defines utility functions to generate random set difference queries.
  */
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <condition_variable>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <mutex>
 #include <random>
+#include <thread>
 #include <vector>
 
 /// @brief Generates insertion and removal queries.
@@ -44,4 +51,179 @@
   copy(removals.cbegin(), next(removals.cbegin(), num_removals),
        std::back_inserter(insertions));
   return insertions;
+}
+
+/// @brief Computes the Philox4x32-10 counter-based random function, see
+/// Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3" (SC 2011).
+/// Every distinct counter gives four independent random words, so random
+/// numbers can be generated for any position of a sequence without
+/// generating the ones before it.
+/// @param counter the position in the random sequence
+/// @param key the seed of the random sequence
+/// @return four random words
+[[nodiscard]] constexpr std::array<std::uint32_t, 4> philox4x32(
+    std::array<std::uint32_t, 4> counter, std::array<std::uint32_t, 2> key) {
+  constexpr std::uint64_t multiplier0 = 0xD2511F53;
+  constexpr std::uint64_t multiplier1 = 0xCD9E8D57;
+  for (int round = 0; round < 10; ++round) {
+    const auto product0 = multiplier0 * counter[0];
+    const auto product1 = multiplier1 * counter[2];
+    counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+               static_cast<std::uint32_t>(product1),
+               static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+               static_cast<std::uint32_t>(product0)};
+    key[0] += 0x9E3779B9;
+    key[1] += 0xBB67AE85;
+  }
+  return counter;
+}
+
+/// @brief Maps `index` to its position in a pseudorandom permutation of
+/// `{0, ..., size - 1}` selected by `seed`. Applies a four-round Feistel
+/// network keyed by Philox to the smallest even-width bit string that holds
+/// every index, and applies it again while the result is out of range. The
+/// network is a bijection, so distinct indices give distinct positions.
+/// @param index the index to permute, less than `size`
+/// @param size the number of permuted indices
+/// @param seed a seed to select the permutation
+/// @return the position of `index` in the permutation
+[[nodiscard]] std::uint64_t random_permutation(std::uint64_t index,
+                                               std::uint64_t size,
+                                               unsigned int seed) {
+  assert(index < size);
+  unsigned int half_width = 1;
+  while (half_width < 32 && (std::uint64_t{1} << (2 * half_width)) < size) {
+    ++half_width;
+  }
+  const auto mask = (std::uint64_t{1} << half_width) - 1;
+  do {
+    auto left = index >> half_width;
+    auto right = index & mask;
+    for (std::uint32_t round = 0; round < 4; ++round) {
+      const auto random = philox4x32({static_cast<std::uint32_t>(right),
+                                      static_cast<std::uint32_t>(right >> 32),
+                                      round, 1},
+                                     {seed, 0})[0];
+      left ^= random & mask;
+      std::swap(left, right);
+    }
+    index = left << half_width | right;
+  } while (index >= size);
+  return index;
+}
+
+/// @brief Generates the same kind of queries as `generate_random_queries`,
+/// but with a counter-based random function, so that every query depends
+/// only on its position and the seed. Chunks of queries are generated by
+/// `num_threads` threads in parallel and written to `out` in order, so the
+/// result does not depend on the number of threads or the chunk size and at
+/// most `num_threads * chunk_size` queries are held in memory. The i-th
+/// insertion inserts `philox4x32({i, i >> 32, 0, 0}, {seed, 0})[0] %
+/// max_value`, and the removals remove the insertions selected by a random
+/// permutation of their indices. This mode gives different queries than
+/// `generate_random_queries` for the same seed.
+/// @param num_insertions the number of insertion queries to generate
+/// @param num_removals the number of removal queries to generate
+/// @param max_value an upper bound on the values appearing in queries
+/// @param seed a seed to use for random number generation
+/// @param out the beginning of the destination range
+/// @param num_threads the number of threads to use, at least one
+/// @param chunk_size the number of queries each thread generates at a time
+/// @return Output iterator to the query past the last query written
+template <class OutputIt>
+OutputIt generate_random_queries_parallel(
+    std::uint64_t num_insertions, std::uint64_t num_removals,
+    unsigned int max_value, unsigned int seed, OutputIt out,
+    unsigned int num_threads = std::thread::hardware_concurrency(),
+    std::size_t chunk_size = 1 << 16) {
+  assert(num_removals <= num_insertions);
+  assert(0 < max_value && max_value <= std::numeric_limits<int>::max());
+
+  const auto insertion = [max_value, seed](std::uint64_t index) {
+    const auto random = philox4x32({static_cast<std::uint32_t>(index),
+                                    static_cast<std::uint32_t>(index >> 32),
+                                    0, 0},
+                                   {seed, 0})[0];
+    return static_cast<int>(random % max_value);
+  };
+  const auto query = [&](std::uint64_t index) {
+    return index < num_insertions
+               ? insertion(index)
+               : ~insertion(random_permutation(index - num_insertions,
+                                               num_insertions, seed));
+  };
+
+  const auto num_chunks = static_cast<std::size_t>(std::max(num_threads, 1U));
+  chunk_size = std::max<std::size_t>(chunk_size, 1);
+  const auto num_queries = num_insertions + num_removals;
+  const auto round_size = num_chunks * chunk_size;
+  const auto num_rounds = (num_queries + round_size - 1) / round_size;
+  std::vector<std::vector<int>> chunks(num_chunks);
+  const auto generate = [&](std::size_t chunk, std::uint64_t round) {
+    const auto first = std::min<std::uint64_t>(
+        round * round_size + chunk * chunk_size, num_queries);
+    const auto last = std::min<std::uint64_t>(first + chunk_size, num_queries);
+    chunks[chunk].resize(static_cast<std::size_t>(last - first));
+    for (auto index = first; index < last; ++index) {
+      chunks[chunk][static_cast<std::size_t>(index - first)] = query(index);
+    }
+  };
+
+  // The threads are started once and generate one chunk per round, then wait
+  // until the calling thread has written the round out before reusing their
+  // chunk. Setting num_written to num_rounds stops them early.
+  std::mutex mutex;
+  std::condition_variable generated;
+  std::condition_variable written;
+  std::size_t num_generated = 0;
+  std::uint64_t num_written = 0;
+  std::vector<std::thread> threads;
+  threads.reserve(num_chunks - 1);
+  const auto stop = [&] {
+    {
+      const std::lock_guard lock(mutex);
+      num_written = num_rounds;
+    }
+    written.notify_all();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+  try {
+    for (std::size_t chunk = 1; chunk < num_chunks; ++chunk) {
+      threads.emplace_back([&, chunk] {
+        for (std::uint64_t round = 0; round < num_rounds; ++round) {
+          generate(chunk, round);
+          std::unique_lock lock(mutex);
+          ++num_generated;
+          generated.notify_one();
+          written.wait(lock, [&] { return num_written > round; });
+          if (num_written == num_rounds) {
+            return;
+          }
+        }
+      });
+    }
+    for (std::uint64_t round = 0; round < num_rounds; ++round) {
+      generate(0, round);
+      {
+        std::unique_lock lock(mutex);
+        generated.wait(lock, [&] { return num_generated + 1 == num_chunks; });
+        num_generated = 0;
+      }
+      for (const auto& chunk : chunks) {
+        out = std::copy(chunk.cbegin(), chunk.cend(), out);
+      }
+      {
+        const std::lock_guard lock(mutex);
+        ++num_written;
+      }
+      written.notify_all();
+    }
+  } catch (...) {
+    stop();
+    throw;
+  }
+  stop();
+  return out;
 }
\ No newline at end of file
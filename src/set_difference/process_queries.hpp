@@ -1,14 +1,35 @@
 /**
  * @file
- * @brief Defines three algorithms capable of processing set difference queries.
+ * @brief Defines algorithms capable of processing set difference queries.
  */
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <limits>
 #include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "lib.hpp"
+#include "set_difference/query_log.hpp"
+
+/// @brief Returns the largest value that appears in the queries.
+/// @param queries a list of queries where nonnegative values represent
+/// insertions and negative ones represent removals, with ~x removing a
+/// previously inserted value of x
+/// @return the largest inserted or removed value, or zero if there are none
+[[nodiscard]] int max_query_value(const std::vector<int>& queries) {
+  int max_value = 0;
+  for (const auto& query : queries) {
+    max_value = std::max(max_value, query >= 0 ? query : ~query);
+  }
+  return max_value;
+}
 
 /// @brief Processes set difference queries using sorting and
 /// std::set_difference. This is an
@@ -35,6 +56,73 @@
   return answer;
 }
 
+/// @brief Sorts nonnegative integers with an LSD radix sort on 8-bit digits.
+/// Builds the histograms of all digits in one pass, then distributes the
+/// values between `values` and `buffer` once per digit, skipping digits that
+/// are equal in all values.
+/// @param values the values to sort, all of them nonnegative
+/// @param buffer scratch space, its contents are unspecified afterwards
+void radix_sort(std::vector<int>& values, std::vector<int>& buffer) {
+  constexpr int digit_width = 8;
+  constexpr std::size_t num_digits = 4;
+  constexpr std::size_t radix = std::size_t{1} << digit_width;
+  std::array<std::array<std::size_t, radix>, num_digits> counts{};
+  for (const auto& value : values) {
+    const auto bits = static_cast<unsigned int>(value);
+    for (std::size_t digit = 0; digit < num_digits; ++digit) {
+      ++counts[digit][(bits >> (digit * digit_width)) & (radix - 1)];
+    }
+  }
+
+  buffer.resize(values.size());
+  for (std::size_t digit = 0; digit < num_digits; ++digit) {
+    auto& offsets = counts[digit];
+    if (std::find(offsets.cbegin(), offsets.cend(), values.size()) !=
+        offsets.cend()) {
+      continue;
+    }
+    std::size_t offset = 0;
+    for (auto& count : offsets) {
+      offset += std::exchange(count, offset);
+    }
+    for (const auto& value : values) {
+      const auto bits = static_cast<unsigned int>(value);
+      buffer[offsets[(bits >> (digit * digit_width)) & (radix - 1)]++] = value;
+    }
+    values.swap(buffer);
+  }
+}
+
+/// @brief Processes set difference queries using LSD radix sort and
+/// std::set_difference. This is an
+/// [offline](https://en.wikipedia.org/wiki/Online_algorithm) algorithm.
+/// @param queries a list of queries where nonnegative values represent
+/// insertions and negative ones represent removals, with ~x removing a
+/// previously inserted value of x
+/// @return (multi)set difference of all inserted values and all removed values
+[[nodiscard]] std::vector<int> process_queries_radix(
+    const std::vector<int>& queries) {
+  std::vector<int> insertions;
+  std::vector<int> removals;
+  for (const auto& query : queries) {
+    if (query >= 0) {
+      insertions.push_back(query);
+    } else {
+      removals.push_back(~query);
+    }
+  }
+  std::vector<int> buffer;
+  radix_sort(insertions, buffer);
+  radix_sort(removals, buffer);
+
+  std::vector<int> answer;
+  answer.reserve(insertions.size() - removals.size());
+  std::set_difference(insertions.cbegin(), insertions.cend(),
+                      removals.cbegin(), removals.cend(),
+                      std::back_inserter(answer));
+  return answer;
+}
+
 /// @brief Processes set difference queries using std::multiset. This is an
 /// [online](https://en.wikipedia.org/wiki/Online_algorithm) algorithm.
 /// @param queries a list of queries where nonnegative values represent
@@ -54,6 +142,27 @@
   return {container.cbegin(), container.cend()};
 }
 
+/// @brief Processes set difference queries read from a query log using
+/// std::multiset, one chunk at a time.
+/// @param log a reader of a query log, see `process_queries_multiset()` for
+/// the meaning of the queries
+/// @return (multi)set difference of all inserted values and all removed values
+/// @throws std::runtime_error if the log cannot be read
+[[nodiscard]] std::vector<int> process_queries_multiset(
+    query_log_reader& log) {
+  std::multiset<int> container;
+  for (std::vector<int> queries; log.read(queries);) {
+    for (const auto& query : queries) {
+      if (query >= 0) {
+        container.insert(query);
+      } else {
+        container.erase(container.find(~query));
+      }
+    }
+  }
+  return {container.cbegin(), container.cend()};
+}
+
 /// @brief Processes set difference queries using a lazy priority queue. This is
 /// an [offline](https://en.wikipedia.org/wiki/Online_algorithm) algorithm.
 /// @param queries a list of queries where nonnegative values represent
@@ -73,9 +182,209 @@
 
   std::vector<int> answer;
   answer.reserve(static_cast<size_t>(container.size()));
-  while (!container.empty()) {
-    answer.push_back(container.top());
-    container.pop();
+  container.drain_sorted(std::back_inserter(answer), sort_order::ascending);
+  return answer;
+}
+
+/// @brief Processes set difference queries read from a query log using a
+/// lazy priority queue, one chunk at a time.
+/// @param log a reader of a query log, see `process_queries_lazypq()` for the
+/// meaning of the queries
+/// @return (multi)set difference of all inserted values and all removed values
+/// @throws std::runtime_error if the log cannot be read
+[[nodiscard]] std::vector<int> process_queries_lazypq(query_log_reader& log) {
+  lazy_priority_queue<int> container;
+  for (std::vector<int> queries; log.read(queries);) {
+    for (const auto& query : queries) {
+      if (query >= 0) {
+        container.push(query);
+      } else {
+        container.erase(~query);
+      }
+    }
+  }
+
+  std::vector<int> answer;
+  answer.reserve(static_cast<size_t>(container.size()));
+  container.drain_sorted(std::back_inserter(answer), sort_order::ascending);
+  return answer;
+}
+
+/// @brief The fewest queries per thread for which `process_queries_parallel`
+/// starts threads. Sorting this many queries takes milliseconds, while
+/// starting and joining a thread takes tens of microseconds, so every thread
+/// started pays for itself.
+constexpr std::size_t min_queries_per_thread = 1 << 16;
+
+/// @brief Processes set difference queries using sorting on several threads.
+/// Values are partitioned into one contiguous value range per thread. Every
+/// thread first splits its share of the queries by range, then sorts the
+/// insertions and removals of one range and computes their difference. The
+/// results of the ranges are already ordered, so concatenating them gives the
+/// same result as `process_queries_sort`. Uses at most one thread per
+/// `min_queries_per_thread` queries, and falls back to
+/// `process_queries_radix` on the calling thread below twice that many. This
+/// is an [offline](https://en.wikipedia.org/wiki/Online_algorithm) algorithm.
+/// @param queries a list of queries where nonnegative values represent
+/// insertions and negative ones represent removals, with ~x removing a
+/// previously inserted value of x
+/// @param num_threads the largest number of threads to use, at least one
+/// @return (multi)set difference of all inserted values and all removed values
+[[nodiscard]] std::vector<int> process_queries_parallel(
+    const std::vector<int>& queries,
+    unsigned int num_threads = std::thread::hardware_concurrency()) {
+  const auto num_shards = std::clamp<std::size_t>(
+      queries.size() / min_queries_per_thread, 1, std::max(num_threads, 1U));
+  if (num_shards == 1) {
+    return process_queries_radix(queries);
+  }
+  const auto range =
+      static_cast<std::uint64_t>(max_query_value(queries)) + 1;
+  const auto shard_of = [num_shards, range](int value) {
+    return static_cast<std::size_t>(static_cast<std::uint64_t>(value) *
+                                    num_shards / range);
+  };
+
+  // shards[chunk][shard] holds the queries of one chunk that fall into the
+  // value range of one shard, with removals already decoded
+  struct shard {
+    std::vector<int> insertions;
+    std::vector<int> removals;
+  };
+  std::vector<std::vector<shard>> shards(num_shards,
+                                         std::vector<shard>(num_shards));
+  const auto chunk_size = (queries.size() + num_shards - 1) / num_shards;
+  const auto run = [num_shards](auto&& task) {
+    std::vector<std::thread> threads;
+    threads.reserve(num_shards - 1);
+    for (std::size_t index = 1; index < num_shards; ++index) {
+      threads.emplace_back(task, index);
+    }
+    task(0);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  run([&](std::size_t chunk) {
+    const auto first = std::min(chunk * chunk_size, queries.size());
+    const auto last = std::min(first + chunk_size, queries.size());
+    for (auto index = first; index < last; ++index) {
+      const auto query = queries[index];
+      if (query >= 0) {
+        shards[chunk][shard_of(query)].insertions.push_back(query);
+      } else {
+        shards[chunk][shard_of(~query)].removals.push_back(~query);
+      }
+    }
+  });
+
+  std::vector<std::vector<int>> answers(num_shards);
+  run([&](std::size_t index) {
+    std::vector<int> insertions;
+    std::vector<int> removals;
+    for (auto& chunk : shards) {
+      auto& part = chunk[index];
+      insertions.insert(insertions.end(), part.insertions.cbegin(),
+                        part.insertions.cend());
+      removals.insert(removals.end(), part.removals.cbegin(),
+                      part.removals.cend());
+      part = shard();
+    }
+    std::sort(insertions.begin(), insertions.end());
+    std::sort(removals.begin(), removals.end());
+    answers[index].reserve(insertions.size() - removals.size());
+    std::set_difference(insertions.cbegin(), insertions.cend(),
+                        removals.cbegin(), removals.cend(),
+                        std::back_inserter(answers[index]));
+  });
+
+  std::size_t answer_size = 0;
+  for (const auto& part : answers) {
+    answer_size += part.size();
+  }
+  std::vector<int> answer;
+  answer.reserve(answer_size);
+  for (const auto& part : answers) {
+    answer.insert(answer.end(), part.cbegin(), part.cend());
+  }
+  return answer;
+}
+
+/// @brief Returns whether `process_queries_counting` counts the values of
+/// queries in an array instead of a hash table, which is when the array has
+/// at most a few entries per query.
+/// @param max_value the largest value that appears in the queries
+/// @param num_queries the number of queries
+[[nodiscard]] bool counts_in_array(int max_value, std::size_t num_queries) {
+  return num_queries <= std::numeric_limits<std::uint32_t>::max() &&
+         static_cast<std::size_t>(max_value) <
+             std::max<std::size_t>(4 * num_queries, 1 << 16);
+}
+
+/// @brief Processes set difference queries by counting the multiplicity of
+/// every value, which takes constant time per query and a single scan over
+/// the counts. The counts are kept in an array indexed by value if the
+/// values are small enough, see `counts_in_array()`, and in a hash table
+/// otherwise. This is an
+/// [online](https://en.wikipedia.org/wiki/Online_algorithm) algorithm.
+/// @param queries a list of queries where nonnegative values represent
+/// insertions and negative ones represent removals, with ~x removing a
+/// previously inserted value of x
+/// @return (multi)set difference of all inserted values and all removed values
+[[nodiscard]] std::vector<int> process_queries_counting(
+    const std::vector<int>& queries) {
+  std::vector<int> answer;
+  const auto max_value = max_query_value(queries);
+  if (counts_in_array(max_value, queries.size())) {
+    std::vector<std::uint32_t> counts(static_cast<std::size_t>(max_value) + 1);
+    for (const auto& query : queries) {
+      if (query >= 0) {
+        ++counts[query];
+      } else {
+        --counts[~query];
+      }
+    }
+    for (int value = 0; value <= max_value; ++value) {
+      answer.insert(answer.end(), counts[value], value);
+    }
+    return answer;
+  }
+
+  std::unordered_map<int, std::size_t> counts;
+  for (const auto& query : queries) {
+    if (query >= 0) {
+      ++counts[query];
+    } else if (const auto it = counts.find(~query); --it->second == 0) {
+      counts.erase(it);
+    }
+  }
+  std::vector<std::pair<int, std::size_t>> sorted(counts.cbegin(),
+                                                  counts.cend());
+  std::sort(sorted.begin(), sorted.end());
+  for (const auto& [value, count] : sorted) {
+    answer.insert(answer.end(), count, value);
+  }
+  return answer;
+}
+
+/// @brief Processes set difference queries with the processor expected to be
+/// the fastest for them. Counts values in an array if they are small
+/// compared to the number of queries, splits large inputs by value range
+/// across all hardware threads, and radix sorts otherwise. This is an
+/// [offline](https://en.wikipedia.org/wiki/Online_algorithm) algorithm.
+/// @param queries a list of queries where nonnegative values represent
+/// insertions and negative ones represent removals, with ~x removing a
+/// previously inserted value of x
+/// @return (multi)set difference of all inserted values and all removed values
+[[nodiscard]] std::vector<int> process_queries(
+    const std::vector<int>& queries) {
+  if (counts_in_array(max_query_value(queries), queries.size())) {
+    return process_queries_counting(queries);
+  }
+  if (queries.size() >= 2 * min_queries_per_thread &&
+      std::thread::hardware_concurrency() > 1) {
+    return process_queries_parallel(queries);
   }
-  return {answer.crbegin(), answer.crend()};
+  return process_queries_radix(queries);
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @brief Defines a compact binary file format for set difference queries
+ * together with a streaming writer and a chunked reader.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(sizeof(int) == sizeof(std::int32_t),
+              "queries are stored as 32-bit integers");
+
+/// @brief The header of a query log file. It is followed by `num_queries`
+/// queries stored as 32-bit integers, all in host byte order, so a log written
+/// on a host with a different byte order is rejected by its magic number.
+struct query_log_header {
+  /// @brief Identifies query log files, "LPQL" in little-endian order.
+  static constexpr std::uint32_t expected_magic = 0x4C51504C;
+  /// @brief The version of the format described by this header.
+  static constexpr std::uint32_t current_version = 1;
+
+  std::uint32_t magic = expected_magic;
+  std::uint32_t version = current_version;
+  std::uint64_t num_queries{};
+};
+
+/// @brief Writes queries to a query log file as they arrive, so that a log
+/// need not fit in memory. The number of queries in the header is written by
+/// `close()`.
+class query_log_writer {
+ public:
+  /// @brief Creates or truncates the file at `path` and writes a header.
+  /// @param path the path of the query log file
+  /// @throws std::runtime_error if the file cannot be opened or written
+  explicit query_log_writer(const std::string& path)
+      : path_(path), file_(path, std::ios::binary | std::ios::trunc) {
+    if (!file_) {
+      throw std::runtime_error("cannot open query log " + path_);
+    }
+    write_header();
+  }
+
+  query_log_writer(const query_log_writer&) = delete;
+  query_log_writer& operator=(const query_log_writer&) = delete;
+
+  /// @brief Closes the file if `close()` was not called. Errors are ignored,
+  /// so call `close()` to detect them.
+  ~query_log_writer() {
+    try {
+      close();
+    } catch (const std::runtime_error&) {
+    }
+  }
+
+  /// @brief Appends a query to the log.
+  /// @param query a nonnegative value x to insert x, or ~x to remove x
+  /// @throws std::runtime_error if the file cannot be written
+  void write(int query) { write(&query, &query + 1); }
+
+  /// @brief Appends the given range of queries to the log.
+  /// @param first the beginning of the range of queries to write
+  /// @param last the end of the range of queries to write
+  /// @throws std::runtime_error if the file cannot be written
+  void write(const int* first, const int* last) {
+    const auto count = static_cast<std::size_t>(last - first);
+    file_.write(reinterpret_cast<const char*>(first),
+                static_cast<std::streamsize>(count * sizeof(int)));
+    check();
+    header_.num_queries += count;
+  }
+
+  /// @brief Writes the final header and closes the file. Does nothing if the
+  /// file is already closed.
+  /// @throws std::runtime_error if the file cannot be written
+  void close() {
+    if (!file_.is_open()) {
+      return;
+    }
+    file_.seekp(0);
+    write_header();
+    file_.close();
+    check();
+  }
+
+ private:
+  void write_header() {
+    file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+    check();
+  }
+
+  void check() {
+    if (!file_) {
+      file_.close();
+      throw std::runtime_error("cannot write query log " + path_);
+    }
+  }
+
+  std::string path_;
+  std::ofstream file_;
+  query_log_header header_;
+};
+
+/// @brief Writes all queries to a new query log file at `path`.
+/// @param path the path of the query log file
+/// @param queries a list of queries where nonnegative values represent
+/// insertions and negative ones represent removals, with ~x removing a
+/// previously inserted value of x
+/// @throws std::runtime_error if the file cannot be opened or written
+void write_query_log(const std::string& path, const std::vector<int>& queries) {
+  query_log_writer writer(path);
+  writer.write(queries.data(), queries.data() + queries.size());
+  writer.close();
+}
+
+/// @brief Reads a query log file in chunks of a fixed number of queries, so
+/// that only one chunk is held in memory at a time.
+class query_log_reader {
+ public:
+  /// @brief Opens the file at `path` and validates its header.
+  /// @param path the path of the query log file
+  /// @param chunk_size the largest number of queries returned by `read()`
+  /// @throws std::runtime_error if the file cannot be opened or is not a
+  /// query log of the current version
+  explicit query_log_reader(const std::string& path,
+                            std::size_t chunk_size = 1 << 16)
+      : path_(path),
+        file_(path, std::ios::binary),
+        chunk_size_(std::max<std::size_t>(chunk_size, 1)) {
+    if (!file_) {
+      throw std::runtime_error("cannot open query log " + path_);
+    }
+    file_.read(reinterpret_cast<char*>(&header_), sizeof(header_));
+    if (file_.gcount() != sizeof(header_) ||
+        header_.magic != query_log_header::expected_magic) {
+      throw std::runtime_error("not a query log " + path_);
+    }
+    if (header_.version != query_log_header::current_version) {
+      throw std::runtime_error("unsupported query log version " +
+                               std::to_string(header_.version) + " in " +
+                               path_);
+    }
+  }
+
+  /// @brief Returns the number of queries in the log.
+  [[nodiscard]] std::uint64_t size() const { return header_.num_queries; }
+
+  /// @brief Replaces the contents of `chunk` with the next queries in the
+  /// log, at most `chunk_size` of them.
+  /// @param chunk the vector to store the queries in
+  /// @return `false` if every query has already been read, `true` otherwise
+  /// @throws std::runtime_error if the file is shorter than its header says
+  bool read(std::vector<int>& chunk) {
+    const auto count = static_cast<std::size_t>(
+        std::min<std::uint64_t>(chunk_size_, header_.num_queries - num_read_));
+    chunk.resize(count);
+    if (count == 0) {
+      return false;
+    }
+    const auto bytes = static_cast<std::streamsize>(count * sizeof(int));
+    file_.read(reinterpret_cast<char*>(chunk.data()), bytes);
+    if (file_.gcount() != bytes) {
+      throw std::runtime_error("truncated query log " + path_);
+    }
+    num_read_ += count;
+    return true;
+  }
+
+ private:
+  std::string path_;
+  std::ifstream file_;
+  std::size_t chunk_size_;
+  query_log_header header_;
+  std::uint64_t num_read_{};
+};
\ No newline at end of file
@@ -0,0 +1,298 @@
+/**
+ * @file
+ * @brief Defines vectorized kernels that select the best child of a d-ary heap
+ * node among 4 or 8 adjacent arithmetic keys.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+// The kernels need GNU target attributes and builtins on x86. Defining
+// LAZY_PRIORITY_QUEUE_NO_SIMD compiles them out, leaving the scalar loop.
+#if !defined(LAZY_PRIORITY_QUEUE_NO_SIMD) &&    \
+    (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define LAZY_PRIORITY_QUEUE_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+/// @brief Whether `T` is a key type with a vectorized kernel.
+template <class T>
+inline constexpr bool is_key_v =
+    std::is_same_v<T, int> || std::is_same_v<T, float> ||
+    std::is_same_v<T, double> || std::is_same_v<T, std::uint64_t>;
+
+/// @brief Whether `Compare` orders keys of type `T` like `std::less` or
+/// `std::greater`, so that the best child is the greatest or the least key.
+template <class Compare, class T>
+inline constexpr bool is_compare_v =
+    std::is_same_v<Compare, std::less<T>> ||
+    std::is_same_v<Compare, std::less<>> ||
+    std::is_same_v<Compare, std::greater<T>> ||
+    std::is_same_v<Compare, std::greater<>>;
+
+/// @brief Whether the best child under `Compare` is the greatest key.
+template <class Compare, class T>
+inline constexpr bool selects_greatest_v =
+    std::is_same_v<Compare, std::less<T>> ||
+    std::is_same_v<Compare, std::less<>>;
+
+/// @brief Whether `RandomIt` points into contiguous storage of `T`.
+template <class RandomIt, class T>
+inline constexpr bool is_contiguous_v =
+    std::is_same_v<RandomIt, T*> ||
+    std::is_same_v<RandomIt, typename std::vector<T>::iterator> ||
+    std::is_same_v<RandomIt, typename std::pmr::vector<T>::iterator>;
+
+/// @brief Whether `d_ary_heap<Arity>` can select the best child of a node in a
+/// range of `RandomIt` ordered by `Compare` with a vectorized kernel. Always
+/// `false` on compilers and architectures without one.
+template <std::size_t Arity, class RandomIt, class Compare>
+inline constexpr bool is_vectorizable_v =
+#ifdef LAZY_PRIORITY_QUEUE_X86_SIMD
+    (Arity == 4 || Arity == 8) &&
+    is_key_v<typename std::iterator_traits<RandomIt>::value_type> &&
+    is_compare_v<Compare,
+                 typename std::iterator_traits<RandomIt>::value_type> &&
+    is_contiguous_v<RandomIt,
+                    typename std::iterator_traits<RandomIt>::value_type>;
+#else
+    false;
+#endif
+
+#ifdef LAZY_PRIORITY_QUEUE_X86_SIMD
+
+/// @brief Returns whether the CPU supports AVX2, checked once.
+inline bool has_avx2() {
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+}
+
+/// @brief Returns whether the CPU supports SSE4.1, checked once.
+inline bool has_sse41() {
+  static const bool supported = __builtin_cpu_supports("sse4.1");
+  return supported;
+}
+
+/// @brief Returns whether the CPU can run `best_of<Arity>` for keys of type
+/// `T`. 4 keys of type `int` or `float` need SSE4.1, every other kernel needs
+/// AVX2.
+template <std::size_t Arity, class T>
+bool supported() {
+  if constexpr (Arity == 4 &&
+                (std::is_same_v<T, int> || std::is_same_v<T, float>)) {
+    return has_sse41();
+  } else {
+    return has_avx2();
+  }
+}
+
+// Every kernel reduces the keys to the best one by repeatedly combining the
+// vector with a permutation of itself, then compares the keys with the best
+// one and returns the position of the first match, as the scalar loop does.
+
+template <bool Greatest>
+__attribute__((target("sse4.1"))) inline __m128i select_epi32(__m128i lhs,
+                                                              __m128i rhs) {
+  if constexpr (Greatest) {
+    return _mm_max_epi32(lhs, rhs);
+  } else {
+    return _mm_min_epi32(lhs, rhs);
+  }
+}
+
+template <bool Greatest>
+__attribute__((target("sse4.1"))) inline __m128 select_ps(__m128 lhs,
+                                                          __m128 rhs) {
+  if constexpr (Greatest) {
+    return _mm_max_ps(lhs, rhs);
+  } else {
+    return _mm_min_ps(lhs, rhs);
+  }
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline __m256i select_epi32(__m256i lhs,
+                                                            __m256i rhs) {
+  if constexpr (Greatest) {
+    return _mm256_max_epi32(lhs, rhs);
+  } else {
+    return _mm256_min_epi32(lhs, rhs);
+  }
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline __m256 select_ps(__m256 lhs,
+                                                        __m256 rhs) {
+  if constexpr (Greatest) {
+    return _mm256_max_ps(lhs, rhs);
+  } else {
+    return _mm256_min_ps(lhs, rhs);
+  }
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline __m256d select_pd(__m256d lhs,
+                                                         __m256d rhs) {
+  if constexpr (Greatest) {
+    return _mm256_max_pd(lhs, rhs);
+  } else {
+    return _mm256_min_pd(lhs, rhs);
+  }
+}
+
+// AVX2 only compares signed 64-bit integers, so unsigned keys are compared
+// with their sign bits flipped
+template <bool Greatest>
+__attribute__((target("avx2"))) inline __m256i select_epi64(__m256i lhs,
+                                                            __m256i rhs) {
+  const auto greater = _mm256_cmpgt_epi64(lhs, rhs);
+  if constexpr (Greatest) {
+    return _mm256_blendv_epi8(rhs, lhs, greater);
+  } else {
+    return _mm256_blendv_epi8(lhs, rhs, greater);
+  }
+}
+
+template <bool Greatest>
+__attribute__((target("sse4.1"))) inline std::size_t best_of_4(
+    const int* keys) {
+  const auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys));
+  auto best = select_epi32<Greatest>(
+      values, _mm_shuffle_epi32(values, _MM_SHUFFLE(1, 0, 3, 2)));
+  best = select_epi32<Greatest>(
+      best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+  return __builtin_ctz(
+      _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(values, best))));
+}
+
+template <bool Greatest>
+__attribute__((target("sse4.1"))) inline std::size_t best_of_4(
+    const float* keys) {
+  const auto values = _mm_loadu_ps(keys);
+  auto best = select_ps<Greatest>(
+      values, _mm_shuffle_ps(values, values, _MM_SHUFFLE(1, 0, 3, 2)));
+  best = select_ps<Greatest>(
+      best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(2, 3, 0, 1)));
+  return __builtin_ctz(_mm_movemask_ps(_mm_cmpeq_ps(values, best)));
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline std::size_t best_of_8(
+    const int* keys) {
+  const auto values =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+  auto best = select_epi32<Greatest>(
+      values, _mm256_permute2x128_si256(values, values, 1));
+  best = select_epi32<Greatest>(
+      best, _mm256_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+  best = select_epi32<Greatest>(
+      best, _mm256_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+  return __builtin_ctz(_mm256_movemask_ps(
+      _mm256_castsi256_ps(_mm256_cmpeq_epi32(values, best))));
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline std::size_t best_of_8(
+    const float* keys) {
+  const auto values = _mm256_loadu_ps(keys);
+  auto best = select_ps<Greatest>(
+      values, _mm256_permute2f128_ps(values, values, 1));
+  best = select_ps<Greatest>(
+      best, _mm256_shuffle_ps(best, best, _MM_SHUFFLE(1, 0, 3, 2)));
+  best = select_ps<Greatest>(
+      best, _mm256_shuffle_ps(best, best, _MM_SHUFFLE(2, 3, 0, 1)));
+  return __builtin_ctz(
+      _mm256_movemask_ps(_mm256_cmp_ps(values, best, _CMP_EQ_OQ)));
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline __m256d reduce_pd(__m256d values) {
+  const auto best = select_pd<Greatest>(
+      values, _mm256_permute2f128_pd(values, values, 1));
+  return select_pd<Greatest>(best, _mm256_shuffle_pd(best, best, 0b0101));
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline std::size_t best_of_4(
+    const double* keys) {
+  const auto values = _mm256_loadu_pd(keys);
+  const auto best = reduce_pd<Greatest>(values);
+  return __builtin_ctz(
+      _mm256_movemask_pd(_mm256_cmp_pd(values, best, _CMP_EQ_OQ)));
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline std::size_t best_of_8(
+    const double* keys) {
+  const auto low = _mm256_loadu_pd(keys);
+  const auto high = _mm256_loadu_pd(keys + 4);
+  const auto best = reduce_pd<Greatest>(select_pd<Greatest>(low, high));
+  return __builtin_ctz(
+      _mm256_movemask_pd(_mm256_cmp_pd(low, best, _CMP_EQ_OQ)) |
+      _mm256_movemask_pd(_mm256_cmp_pd(high, best, _CMP_EQ_OQ)) << 4);
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline __m256i reduce_epi64(__m256i values) {
+  const auto best = select_epi64<Greatest>(
+      values, _mm256_permute2x128_si256(values, values, 1));
+  return select_epi64<Greatest>(
+      best, _mm256_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline std::size_t best_of_4(
+    const std::uint64_t* keys) {
+  const auto sign = _mm256_set1_epi64x(INT64_MIN);
+  const auto values = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)), sign);
+  const auto best = reduce_epi64<Greatest>(values);
+  return __builtin_ctz(_mm256_movemask_pd(
+      _mm256_castsi256_pd(_mm256_cmpeq_epi64(values, best))));
+}
+
+template <bool Greatest>
+__attribute__((target("avx2"))) inline std::size_t best_of_8(
+    const std::uint64_t* keys) {
+  const auto sign = _mm256_set1_epi64x(INT64_MIN);
+  const auto low = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)), sign);
+  const auto high = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + 4)), sign);
+  const auto best = reduce_epi64<Greatest>(select_epi64<Greatest>(low, high));
+  return __builtin_ctz(
+      _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(low, best))) |
+      _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(high, best)))
+          << 4);
+}
+
+/// @brief Returns the position of the first greatest key among `Arity`
+/// adjacent keys if `Greatest` is set, or of the first least key otherwise.
+/// The behavior is undefined if `supported<Arity, T>()` is `false` or if a
+/// floating-point key is NaN.
+/// @tparam Arity the number of keys, 4 or 8
+/// @tparam Greatest whether to select the greatest key
+/// @param keys pointer to the first key
+template <std::size_t Arity, bool Greatest, class T>
+std::size_t best_of(const T* keys) {
+  static_assert(Arity == 4 || Arity == 8, "no kernel for this arity");
+  if constexpr (Arity == 4) {
+    return best_of_4<Greatest>(keys);
+  } else {
+    return best_of_8<Greatest>(keys);
+  }
+}
+
+#endif
+
+}  // namespace simd
\ No newline at end of file
@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief Defines statistics policies that instrument a lazy priority queue.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+/// @brief A snapshot of the statistics collected by a lazy priority queue.
+struct lazy_priority_queue_stats {
+  /// @brief The number of inserted elements, including those a constructor
+  /// received.
+  std::size_t pushes{};
+  /// @brief The number of removed elements, excluding pops.
+  std::size_t erases{};
+  /// @brief The number of removed elements annihilated with an inserted one,
+  /// by `purge()` or by compaction.
+  std::size_t annihilations{};
+  /// @brief The largest number of annihilations performed by a single call to
+  /// `purge()`.
+  std::size_t longest_purge{};
+  /// @brief The number of compactions.
+  std::size_t compactions{};
+  /// @brief The largest size of the insert container after a push.
+  std::size_t max_insert_size{};
+  /// @brief The largest size of the remove container after an erase.
+  std::size_t max_remove_size{};
+};
+
+/// @brief Statistics policy that collects nothing. Every hook is an empty
+/// inline function and the policy is an empty base, so a queue using it has
+/// neither runtime nor memory overhead.
+struct no_stats {
+  void pushed(std::size_t /*count*/, std::size_t /*insert_size*/) {}
+  void erased(std::size_t /*count*/, std::size_t /*remove_size*/) {}
+  void purged(std::size_t /*annihilations*/) {}
+  void compacted(std::size_t /*annihilations*/) {}
+
+  /// @brief Returns all-zero statistics.
+  [[nodiscard]] lazy_priority_queue_stats snapshot() const { return {}; }
+};
+
+/// @brief Statistics policy that counts pushes, erases, annihilations and
+/// compactions, and tracks the longest purge run and the high-water marks of
+/// both underlying containers.
+class counting_stats {
+ public:
+  void pushed(std::size_t count, std::size_t insert_size) {
+    stats_.pushes += count;
+    stats_.max_insert_size = std::max(stats_.max_insert_size, insert_size);
+  }
+
+  void erased(std::size_t count, std::size_t remove_size) {
+    stats_.erases += count;
+    stats_.max_remove_size = std::max(stats_.max_remove_size, remove_size);
+  }
+
+  void purged(std::size_t annihilations) {
+    stats_.annihilations += annihilations;
+    stats_.longest_purge = std::max(stats_.longest_purge, annihilations);
+  }
+
+  void compacted(std::size_t annihilations) {
+    stats_.annihilations += annihilations;
+    ++stats_.compactions;
+  }
+
+  /// @brief Returns the statistics collected so far.
+  [[nodiscard]] lazy_priority_queue_stats snapshot() const { return stats_; }
+
+ private:
+  lazy_priority_queue_stats stats_;
+};
\ No newline at end of file
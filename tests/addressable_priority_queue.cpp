@@ -0,0 +1,136 @@
+#include "addressable_priority_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST(AddressablePriorityQueueTest, BasicAssertions) {
+  addressable_priority_queue<int> queue;
+  EXPECT_TRUE(queue.empty());
+
+  const auto three = queue.push(3);
+  const auto one = queue.push(1);
+  const auto four = queue.push(4);
+  queue.push(1);
+  const auto five = queue.push(5);
+  EXPECT_EQ(queue.size(), 5);
+  EXPECT_EQ(queue.top(), 5);
+
+  EXPECT_TRUE(queue.erase(five));
+  EXPECT_FALSE(queue.contains(five));
+  EXPECT_FALSE(queue.erase(five));
+  EXPECT_EQ(queue.top(), 4);
+  EXPECT_TRUE(queue.erase(one));
+  EXPECT_EQ(queue.size(), 3);
+
+  // Reuses the slot of an erased element without reviving its handle
+  const auto nine = queue.push(9);
+  EXPECT_EQ(nine.slot, one.slot);
+  EXPECT_FALSE(queue.contains(one));
+  EXPECT_TRUE(queue.contains(nine));
+
+  EXPECT_TRUE(queue.update(nine, 2));
+  EXPECT_TRUE(queue.update(three, 6));
+  EXPECT_EQ(queue.extract_top(), 6);
+  EXPECT_FALSE(queue.update(three, 7));
+  EXPECT_TRUE(queue.contains(four));
+  queue.pop();
+  EXPECT_FALSE(queue.contains(four));
+  EXPECT_EQ(queue.extract_top(), 2);
+  EXPECT_EQ(queue.extract_top(), 1);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(AddressablePriorityQueueTest, Compare) {
+  addressable_priority_queue<std::string, std::greater<std::string>, 4> queue;
+  const auto b = queue.emplace(3, 'b');
+  queue.push("a");
+  queue.push("c");
+  EXPECT_EQ(queue.top(), "a");
+  queue.pop();
+  EXPECT_TRUE(queue.erase(b));
+  EXPECT_EQ(queue.extract_top(), "c");
+  EXPECT_TRUE(queue.empty());
+}
+
+template <std::size_t Arity>
+void expect_matches_multiset() {
+  addressable_priority_queue<int, std::less<int>, Arity> queue;
+  std::multiset<int> expected;
+  std::vector<std::pair<int, typename decltype(queue)::handle>> pushed;
+  std::mt19937 gen(0);
+  for (int index = 0; index < 10000; ++index) {
+    switch (gen() % 4) {
+      case 0:
+      case 1: {
+        const auto value = static_cast<int>(gen() % 1000);
+        pushed.emplace_back(value, queue.push(value));
+        expected.insert(value);
+        break;
+      }
+      case 2: {
+        if (pushed.empty()) {
+          break;
+        }
+        const auto& [value, handle] = pushed[gen() % pushed.size()];
+        const auto erased = queue.erase(handle);
+        EXPECT_FALSE(queue.contains(handle));
+        if (erased) {
+          expected.erase(expected.find(value));
+        }
+        break;
+      }
+      default: {
+        if (expected.empty()) {
+          break;
+        }
+        ASSERT_EQ(queue.top(), *expected.rbegin());
+        queue.pop();
+        expected.erase(std::prev(expected.end()));
+      }
+    }
+    ASSERT_EQ(queue.size(), static_cast<int>(expected.size()));
+  }
+  for (auto it = expected.rbegin(); it != expected.rend(); ++it) {
+    ASSERT_EQ(queue.extract_top(), *it);
+  }
+}
+
+TEST(AddressablePriorityQueueTest, Random) {
+  expect_matches_multiset<2>();
+  expect_matches_multiset<4>();
+  expect_matches_multiset<8>();
+}
+
+TEST(AddressablePriorityQueueTest, ThrowingConstructor) {
+  struct throwing {
+    explicit throwing(int value) : value(value) {
+      if (value < 0) {
+        throw std::invalid_argument("negative value");
+      }
+    }
+
+    bool operator<(const throwing& other) const { return value < other.value; }
+
+    int value;
+  };
+
+  addressable_priority_queue<throwing> queue;
+  const auto first = queue.emplace(1);
+  EXPECT_THROW(queue.emplace(-1), std::invalid_argument);
+  EXPECT_EQ(queue.size(), 1);
+
+  // The failed emplace took no slot, so the next element gets the next one
+  const auto second = queue.emplace(2);
+  EXPECT_EQ(second.slot, first.slot + 1);
+  EXPECT_TRUE(queue.erase(first));
+  EXPECT_EQ(queue.extract_top().value, 2);
+  EXPECT_TRUE(queue.empty());
+}
\ No newline at end of file
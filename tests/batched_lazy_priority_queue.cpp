@@ -0,0 +1,118 @@
+#include "batched_lazy_priority_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+TEST(BatchedLazyPriorityQueueTest, BasicAssertions) {
+  batched_lazy_priority_queue<int> queue(1, 4);
+  EXPECT_EQ(queue.num_producers(), 1);
+  EXPECT_TRUE(queue.empty());
+
+  auto producer = queue.get_producer(0);
+  EXPECT_TRUE(producer.try_push(1));
+  EXPECT_TRUE(producer.try_push(3));
+  EXPECT_TRUE(producer.try_push(2));
+  EXPECT_TRUE(producer.try_erase(2));
+  EXPECT_FALSE(producer.try_push(4));  // the ring is full
+
+  EXPECT_EQ(queue.drain(), 4);
+  EXPECT_EQ(queue.size(), 2);
+  producer.push(4);
+  EXPECT_EQ(queue.top(), 4);
+  producer.erase(3);
+  queue.pop();
+  EXPECT_EQ(queue.extract_top(), 1);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(BatchedLazyPriorityQueueTest, Threads) {
+  constexpr int num_producers = 4;
+  constexpr int num_values = 10'000;
+  batched_lazy_priority_queue<int, std::vector<int>, std::greater<int>> queue(
+      num_producers, 64);
+
+  std::vector<std::thread> producers;
+  for (int index = 0; index < num_producers; ++index) {
+    producers.emplace_back([&queue, index] {
+      auto producer = queue.get_producer(index);
+      for (int value = index; value < num_values; value += num_producers) {
+        producer.push(value);
+        if (value % 3 == 0) {
+          producer.erase(value);
+        }
+      }
+    });
+  }
+
+  // Drains concurrently with the producers, but pops only once every removal
+  // is enqueued, since an element must not be popped before it is erased
+  int num_operations = 0;
+  const auto num_erased = (num_values + 2) / 3;
+  while (num_operations < num_values + num_erased) {
+    num_operations += static_cast<int>(queue.drain());
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  std::vector<int> popped;
+  while (!queue.empty()) {
+    popped.push_back(queue.extract_top());
+  }
+  EXPECT_TRUE(queue.empty());
+
+  std::sort(popped.begin(), popped.end());
+  std::vector<int> expected;
+  for (int value = 0; value < num_values; ++value) {
+    if (value % 3 != 0) {
+      expected.push_back(value);
+    }
+  }
+  EXPECT_EQ(popped, expected);
+}
+
+TEST(BatchedLazyPriorityQueueTest, CrossProducerErase) {
+  constexpr int num_values = 100'000;
+  batched_lazy_priority_queue<int> queue(2, 64);
+  std::atomic<int> num_pushed{};
+  std::atomic<int> num_erased{};
+
+  // Every value is pushed through one producer and erased through the other
+  std::thread pusher([&queue, &num_pushed] {
+    auto producer = queue.get_producer(0);
+    for (int value = 0; value < num_values; ++value) {
+      producer.push(value);
+      num_pushed.store(value + 1, std::memory_order_release);
+    }
+  });
+  std::thread eraser([&queue, &num_pushed, &num_erased] {
+    auto producer = queue.get_producer(1);
+    for (int value = 0; value < num_values; ++value) {
+      while (num_pushed.load(std::memory_order_acquire) <= value) {
+        std::this_thread::yield();
+      }
+      producer.erase(value);
+      num_erased.store(value + 1, std::memory_order_release);
+    }
+  });
+
+  // Values below num_erased were erased before top() drained, so the top
+  // element, the greatest one, is never one of them
+  int num_stale = 0;
+  for (int erased = 0; erased < num_values;) {
+    erased = num_erased.load(std::memory_order_acquire);
+    if (!queue.empty() && queue.top() < erased) {
+      ++num_stale;
+    }
+    std::this_thread::yield();
+  }
+  pusher.join();
+  eraser.join();
+  EXPECT_EQ(num_stale, 0);
+  EXPECT_TRUE(queue.empty());
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "bounded_lazy_priority_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+
+TEST(BoundedLazyPriorityQueueTest, BasicAssertions) {
+  bounded_lazy_priority_queue<int> queue(3);
+  EXPECT_EQ(queue.capacity(), 3);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.erase(1));
+
+  EXPECT_TRUE(queue.push(5));
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(3));
+  EXPECT_TRUE(queue.push(4));  // evicts 1
+  EXPECT_FALSE(queue.push(2));
+  EXPECT_EQ(queue.size(), 3);
+  EXPECT_EQ(queue.top(), 5);
+  EXPECT_EQ(queue.bottom(), 3);
+
+  EXPECT_FALSE(queue.erase(1));  // evicted
+  EXPECT_FALSE(queue.erase(2));  // dropped
+  EXPECT_TRUE(queue.erase(4));
+  EXPECT_EQ(queue.size(), 2);
+  EXPECT_TRUE(queue.push(0));
+  EXPECT_EQ(queue.bottom(), 0);
+
+  queue.pop();
+  EXPECT_EQ(queue.top(), 3);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 0);
+  EXPECT_EQ(queue.bottom(), 0);
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+
+  bounded_lazy_priority_queue<int> none(0);
+  EXPECT_FALSE(none.push(1));
+  EXPECT_TRUE(none.empty());
+}
+
+TEST(BoundedLazyPriorityQueueTest, EraseEvicted) {
+  bounded_lazy_priority_queue<int> queue(2);
+  EXPECT_TRUE(queue.push(5));
+  EXPECT_TRUE(queue.push(4));
+  EXPECT_TRUE(queue.push(6));  // evicts 4
+
+  EXPECT_TRUE(queue.erase(6));
+  EXPECT_TRUE(queue.erase(5));
+  EXPECT_TRUE(queue.push(1));
+  // 4 no longer comes before bottom(), but it was evicted
+  EXPECT_FALSE(queue.erase(4));
+  EXPECT_EQ(queue.size(), 1);
+
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_TRUE(queue.push(3));  // evicts 1
+  EXPECT_FALSE(queue.erase(1));
+  EXPECT_EQ(queue.size(), 2);
+  EXPECT_EQ(queue.top(), 3);
+  EXPECT_EQ(queue.bottom(), 2);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 2);
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+}
+
+namespace {
+
+struct job {
+  int priority;
+  int id;
+
+  bool operator==(const job& other) const {
+    return priority == other.priority && id == other.id;
+  }
+};
+
+struct by_priority {
+  bool operator()(const job& lhs, const job& rhs) const {
+    return lhs.priority < rhs.priority;
+  }
+};
+
+}  // namespace
+
+TEST(BoundedLazyPriorityQueueTest, EquivalentValues) {
+  // Values are matched by equivalence under Compare, not by equality
+  bounded_lazy_priority_queue<job, by_priority> queue(2);
+  EXPECT_TRUE(queue.push({1, 0}));
+  EXPECT_TRUE(queue.push({1, 1}));
+  EXPECT_FALSE(queue.push({1, 2}));
+  EXPECT_EQ(queue.top().priority, 1);
+
+  EXPECT_TRUE(queue.erase({1, 3}));
+  EXPECT_TRUE(queue.erase({1, 2}));
+  EXPECT_FALSE(queue.erase({1, 0}));
+  EXPECT_TRUE(queue.empty());
+
+  EXPECT_TRUE(queue.push({2, 4}));
+  EXPECT_EQ(queue.top(), (job{2, 4}));
+  EXPECT_EQ(queue.bottom(), (job{2, 4}));
+}
+
+TEST(BoundedLazyPriorityQueueTest, Stream) {
+  // Keeps the smallest elements, so the queue always matches the best
+  // elements of a multiset of everything retained so far
+  constexpr std::size_t capacity = 10;
+  bounded_lazy_priority_queue<int, std::greater<int>> queue(capacity);
+  std::multiset<int> expected;
+  std::mt19937 gen(0);
+  for (int round = 0; round < 10'000; ++round) {
+    if (gen() % 4 != 0 || expected.empty()) {
+      const auto value = static_cast<int>(gen() % 1'000);
+      const auto retained = queue.push(value);
+      expected.insert(value);
+      if (expected.size() > capacity) {
+        const auto worst = std::prev(expected.end());
+        EXPECT_EQ(retained, value != *worst);
+        expected.erase(worst);
+      }
+    } else if (gen() % 2 == 0) {
+      const auto it = std::next(expected.begin(), gen() % expected.size());
+      EXPECT_TRUE(queue.erase(*it));
+      expected.erase(it);
+    } else {
+      // Retracts any value, which may have been evicted or never pushed
+      const auto value = static_cast<int>(gen() % 1'000);
+      const auto it = expected.find(value);
+      EXPECT_EQ(queue.erase(value), it != expected.end());
+      if (it != expected.end()) {
+        expected.erase(it);
+      }
+    }
+    ASSERT_EQ(queue.size(), static_cast<int>(expected.size()));
+    if (!expected.empty()) {
+      EXPECT_EQ(queue.top(), *expected.begin());
+      EXPECT_EQ(queue.bottom(), *expected.rbegin());
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "concurrent_lazy_priority_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentLazyPriorityQueueTest, BasicAssertions) {
+  // A single shard behaves exactly like lazy_priority_queue
+  concurrent_lazy_priority_queue<int> queue(1);
+  EXPECT_EQ(queue.num_shards(), 1);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.try_pop(), std::nullopt);
+
+  queue.push(1);
+  queue.push(3);
+  queue.push(2);
+  EXPECT_EQ(queue.size(), 3);
+
+  queue.erase(2);
+  EXPECT_EQ(queue.size(), 2);
+
+  EXPECT_EQ(queue.try_pop(), 3);
+  EXPECT_EQ(queue.try_pop(), 1);
+  EXPECT_EQ(queue.try_pop(), std::nullopt);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(ConcurrentLazyPriorityQueueTest, Shards) {
+  concurrent_lazy_priority_queue<int, std::vector<int>, std::greater<int>>
+      queue(4);
+  EXPECT_EQ(queue.num_shards(), 4);
+  for (int value = 0; value < 100; ++value) {
+    queue.push(value);
+  }
+  for (int value = 0; value < 100; value += 3) {
+    queue.erase(value);
+  }
+  EXPECT_EQ(queue.size(), 66);
+
+  std::vector<int> popped;
+  while (const auto value = queue.try_pop()) {
+    popped.push_back(*value);
+  }
+  EXPECT_TRUE(queue.empty());
+
+  std::sort(popped.begin(), popped.end());
+  std::vector<int> expected;
+  for (int value = 0; value < 100; ++value) {
+    if (value % 3 != 0) {
+      expected.push_back(value);
+    }
+  }
+  EXPECT_EQ(popped, expected);
+}
+
+TEST(ConcurrentLazyPriorityQueueTest, Threads) {
+  constexpr int num_threads = 4;
+  constexpr int num_values = 10'000;
+  concurrent_lazy_priority_queue<int> queue(8);
+
+  // Every thread pushes its own values and erases every other one of them
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < num_threads; ++thread) {
+    threads.emplace_back([&queue, thread]() {
+      for (int value = thread; value < num_values; value += num_threads) {
+        queue.push(value);
+      }
+      for (int value = thread; value < num_values; value += 2 * num_threads) {
+        queue.erase(value);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(queue.size(), num_values / 2);
+
+  // Then every thread pops as many elements as it has left
+  std::vector<std::vector<int>> popped(num_threads);
+  threads.clear();
+  for (int thread = 0; thread < num_threads; ++thread) {
+    threads.emplace_back([&queue, &popped, thread]() {
+      while (popped[thread].size() < num_values / num_threads / 2) {
+        if (const auto value = queue.try_pop()) {
+          popped[thread].push_back(*value);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(queue.empty());
+
+  std::vector<int> all;
+  for (const auto& values : popped) {
+    all.insert(all.end(), values.cbegin(), values.cend());
+  }
+  std::sort(all.begin(), all.end());
+  std::vector<int> expected;
+  for (int value = 0; value < num_values; ++value) {
+    if (value % (2 * num_threads) >= num_threads) {
+      expected.push_back(value);
+    }
+  }
+  EXPECT_EQ(all, expected);
+}
\ No newline at end of file
@@ -1,9 +1,20 @@
 #include <gtest/gtest.h>
 
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <deque>
 #include <functional>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "lib.hpp"
@@ -181,4 +192,437 @@ TEST(InterfaceTest, Compare) {
   queue.pop();
   EXPECT_TRUE(queue.empty());
   EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(InterfaceTest, Heap) {
+  lazy_priority_queue<int, std::vector<int>, std::less<int>, d_ary_heap<4>>
+      queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size(), 0);
+
+  queue.push(1);
+  EXPECT_EQ(queue.size(), 1);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.push(3);
+  EXPECT_EQ(queue.size(), 2);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 3);
+
+  queue.push(2);
+  EXPECT_EQ(queue.size(), 3);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 3);
+
+  queue.erase(2);
+  EXPECT_EQ(queue.size(), 2);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 3);
+
+  queue.pop();
+  EXPECT_EQ(queue.size(), 1);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(InterfaceTest, HeapArity) {
+  std::vector<int> values(1000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<int>(i * 7919 % values.size());
+  }
+
+  lazy_priority_queue<int, std::vector<int>, std::less<int>, d_ary_heap<3>>
+      ternary(values.cbegin(), values.cend());
+  lazy_priority_queue<int, std::deque<int>, std::greater<int>, d_ary_heap<8>>
+      octonary;
+  octonary.push(values.cbegin(), values.cend());
+  for (int value = 0; value < 1000; value += 2) {
+    ternary.erase(value);
+    octonary.erase(value);
+  }
+
+  for (int value = 999; value > 0; value -= 2) {
+    ASSERT_FALSE(ternary.empty());
+    EXPECT_EQ(ternary.top(), value);
+    ternary.pop();
+  }
+  EXPECT_TRUE(ternary.empty());
+
+  for (int value = 1; value < 1000; value += 2) {
+    ASSERT_FALSE(octonary.empty());
+    EXPECT_EQ(octonary.top(), value);
+    octonary.pop();
+  }
+  EXPECT_TRUE(octonary.empty());
+}
+
+TEST(InterfaceTest, Compaction) {
+  // Elements are ordered by priority only, but erased by full equality
+  using element = std::pair<int, char>;
+  auto comp = [](const element& lhs, const element& rhs) {
+    return lhs.first < rhs.first;
+  };
+  lazy_priority_queue<element, std::vector<element>, decltype(comp)> queue(
+      comp);
+  EXPECT_EQ(queue.compaction_threshold(), 0.0);
+  queue.compaction_threshold(0.5);
+  EXPECT_EQ(queue.compaction_threshold(), 0.5);
+
+  for (int priority = 0; priority < 10; ++priority) {
+    queue.push({priority, 'a'});
+    queue.push({priority, 'b'});
+    queue.push({priority, 'b'});
+  }
+  EXPECT_EQ(queue.size(), 30);
+
+  for (int priority = 0; priority < 9; ++priority) {
+    queue.erase({priority, 'b'});
+    queue.erase({priority, priority % 2 == 0 ? 'a' : 'b'});
+  }
+  EXPECT_EQ(queue.size(), 12);
+
+  queue.compact();
+  EXPECT_EQ(queue.size(), 12);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_FALSE(queue.empty());
+    EXPECT_EQ(queue.top().first, 9);
+    queue.pop();
+  }
+  for (int priority = 8; priority >= 0; --priority) {
+    ASSERT_FALSE(queue.empty());
+    EXPECT_EQ(queue.top(),
+              element(priority, priority % 2 == 0 ? 'b' : 'a'));
+    queue.pop();
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(InterfaceTest, CompactionProxiedContainers) {
+  lazy_priority_queue<bool> queue;
+  queue.push(false);
+  queue.push(true);
+  queue.push(false);
+  queue.push(true);
+  queue.erase(false);
+  queue.erase(true);
+  queue.compact();
+  EXPECT_EQ(queue.size(), 2);
+  EXPECT_TRUE(queue.top());
+  queue.pop();
+  EXPECT_FALSE(queue.top());
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(InterfaceTest, Ranges) {
+  lazy_priority_queue<int> queue;
+  const std::vector<int> small{5, 1, 4};
+  std::vector<int> large(100);
+  for (size_t i = 0; i < large.size(); ++i) {
+    large[i] = static_cast<int>(i * 37 % large.size());
+  }
+
+  // Few elements relative to the heap size are sifted up one by one, many
+  // elements are pushed by rebuilding the heap
+  queue.push(small.cbegin(), small.cend());
+  queue.push(large.cbegin(), large.cend());
+  queue.push(small.cbegin(), small.cend());
+  EXPECT_EQ(queue.size(), 106);
+
+  queue.erase(large.cbegin(), large.cend());
+  queue.erase(small.cbegin(), small.cend());
+  EXPECT_EQ(queue.size(), 3);
+
+  EXPECT_EQ(queue.top(), 5);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 4);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 1);
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+}
+
+/// @brief A memory resource that counts the allocations it serves and the
+/// bytes still allocated from it.
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations = 0;
+  std::size_t bytes_in_use = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    bytes_in_use += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    bytes_in_use -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+TEST(InterfaceTest, Allocator) {
+  static_assert(std::uses_allocator_v<pmr::lazy_priority_queue<int>,
+                                      std::pmr::polymorphic_allocator<int>>);
+  counting_resource resource;
+  counting_resource fallback;
+  auto* const previous = std::pmr::set_default_resource(&fallback);
+  {
+    pmr::lazy_priority_queue<int> queue(&resource);
+    queue.reserve(4, 2);
+    EXPECT_EQ(resource.allocations, 2);
+    queue.push(1);
+    queue.push(3);
+    queue.push(2);
+    queue.erase(2);
+    EXPECT_EQ(queue.size(), 2);
+
+    pmr::lazy_priority_queue<int> copy(queue, &resource);
+    queue.shrink_to_fit();
+    EXPECT_EQ(queue.top(), 3);
+    queue.pop();
+    EXPECT_EQ(queue.top(), 1);
+    queue.pop();
+    EXPECT_TRUE(queue.empty());
+
+    const std::pmr::vector<int> values({5, 4}, &resource);
+    pmr::lazy_priority_queue<int, std::greater<int>> minq(std::greater<int>(),
+                                                          values, &resource);
+    minq.push(6);
+    EXPECT_EQ(minq.top(), 4);
+
+    EXPECT_EQ(copy.size(), 2);
+    EXPECT_EQ(copy.top(), 3);
+    EXPECT_GT(resource.bytes_in_use, 0);
+  }
+  std::pmr::set_default_resource(previous);
+  EXPECT_GT(resource.allocations, 2);
+  EXPECT_EQ(resource.bytes_in_use, 0);
+  EXPECT_EQ(fallback.allocations, 0);
+}
+
+template <class Heap>
+void expect_updates() {
+  lazy_priority_queue<int, std::vector<int>, std::less<int>, Heap> queue;
+  const std::vector<int> values{3, 8, 5, 1, 9, 4};
+  queue.push(values.cbegin(), values.cend());
+
+  queue.update(9, 2);  // top, sifted down
+  EXPECT_EQ(queue.top(), 8);
+  queue.update(8, 10);  // top, stays
+  EXPECT_EQ(queue.top(), 10);
+  queue.update(1, 11);  // deep, erased and pushed
+  EXPECT_EQ(queue.top(), 11);
+  queue.erase(5);
+  queue.update(11, 0);  // reveals pending removals below the top
+  EXPECT_EQ(queue.size(), 5);
+
+  std::vector<int> drained;
+  queue.drain_sorted(std::back_inserter(drained));
+  EXPECT_EQ(drained, std::vector<int>({10, 4, 3, 2, 0}));
+}
+
+TEST(InterfaceTest, Update) {
+  expect_updates<binary_heap>();
+  expect_updates<d_ary_heap<2>>();
+  expect_updates<d_ary_heap<4>>();
+}
+
+TEST(InterfaceTest, Merge) {
+  lazy_priority_queue<int> queue;
+  const std::vector<int> values{1, 5, 9};
+  queue.push(values.cbegin(), values.cend());
+  queue.erase(5);
+
+  lazy_priority_queue<int> other;
+  const std::vector<int> other_values{7, 3, 12, 4, 8, 10};
+  other.push(other_values.cbegin(), other_values.cend());
+  other.erase(3);
+  other.erase(12);
+
+  queue.merge(std::move(other));
+  EXPECT_TRUE(other.empty());
+  EXPECT_EQ(queue.size(), 6);
+  std::vector<int> drained;
+  queue.drain_sorted(std::back_inserter(drained));
+  EXPECT_EQ(drained, std::vector<int>({10, 9, 8, 7, 4, 1}));
+
+  other.push(other_values.cbegin(), other_values.cend());
+  other.erase(12);
+  other.merge(std::move(other));
+  EXPECT_EQ(other.size(), 5);
+  EXPECT_EQ(other.top(), 10);
+
+  std::array<std::byte, 1024> buffer;
+  std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size());
+  pmr::lazy_priority_queue<int> small(&resource);
+  small.push(2);
+  pmr::lazy_priority_queue<int> large;
+  large.push(other_values.cbegin(), other_values.cend());
+  large.erase(7);
+  small.merge(std::move(large));
+  EXPECT_EQ(small.size(), 6);
+  EXPECT_EQ(small.top(), 12);
+}
+
+TEST(InterfaceTest, ExtractTop) {
+  lazy_priority_queue<std::string> queue;
+  queue.push("b");
+  queue.push("d");
+  queue.push("c");
+  queue.push("a");
+  queue.erase("d");
+
+  const auto& view = queue;
+  EXPECT_EQ(view.top(), "c");
+  EXPECT_EQ(queue.extract_top(), "c");
+  queue.erase("b");
+  queue.purge();
+  EXPECT_EQ(view.top(), "a");
+  EXPECT_EQ(view.size(), 1);
+  EXPECT_EQ(queue.extract_top(), "a");
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(InterfaceTest, DrainSorted) {
+  lazy_priority_queue<int> queue;
+  const std::vector<int> values{3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  queue.push(values.cbegin(), values.cend());
+  const std::vector<int> removals{1, 9, 5, 3};
+  queue.erase(removals.cbegin(), removals.cend());
+
+  std::vector<int> snapshot;
+  queue.sorted_snapshot(std::back_inserter(snapshot));
+  EXPECT_EQ(snapshot, std::vector<int>({6, 5, 4, 3, 2, 1}));
+  EXPECT_EQ(queue.size(), 6);
+
+  std::vector<int> ascending(queue.size());
+  const auto last =
+      queue.drain_sorted(ascending.begin(), sort_order::ascending);
+  EXPECT_EQ(last, ascending.end());
+  EXPECT_EQ(ascending, std::vector<int>({1, 2, 3, 4, 5, 6}));
+  EXPECT_TRUE(queue.empty());
+
+  lazy_priority_queue<bool> bools;
+  bools.push(true);
+  bools.push(false);
+  bools.push(true);
+  bools.erase(true);
+  std::deque<bool> drained;
+  bools.drain_sorted(std::back_inserter(drained));
+  EXPECT_EQ(drained, std::deque<bool>({true, false}));
+}
+
+template <class Queue>
+[[nodiscard]] std::vector<int> pop_all(Queue& queue) {
+  std::vector<int> values;
+  while (!queue.empty()) {
+    values.push_back(queue.extract_top());
+  }
+  return values;
+}
+
+/// @brief A stream buffer over a string that cannot seek, like a pipe.
+class unseekable_buffer : public std::stringbuf {
+ public:
+  explicit unseekable_buffer(const std::string& contents)
+      : std::stringbuf(contents, std::ios::in) {}
+
+ protected:
+  pos_type seekoff(off_type /*off*/, std::ios::seekdir /*dir*/,
+                   std::ios::openmode /*which*/) override {
+    return pos_type(off_type(-1));
+  }
+
+  pos_type seekpos(pos_type /*pos*/, std::ios::openmode /*which*/) override {
+    return pos_type(off_type(-1));
+  }
+};
+
+TEST(InterfaceTest, Serialize) {
+  using queue_type =
+      lazy_priority_queue<int, std::vector<int>, std::less<int>, d_ary_heap<4>>;
+  queue_type queue;
+  queue.compaction_threshold(4);
+  const std::vector<int> values{3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+  queue.push(values.cbegin(), values.cend());
+  const std::vector<int> removals{1, 9, 5, 3};
+  queue.erase(removals.cbegin(), removals.cend());
+
+  std::stringstream lazy;
+  queue.serialize(lazy);
+  auto restored = queue_type::deserialize(lazy);
+  EXPECT_EQ(restored.compaction_threshold(), 4);
+  EXPECT_EQ(restored.size(), 6);
+  EXPECT_EQ(pop_all(restored), std::vector<int>({6, 5, 4, 3, 2, 1}));
+
+  std::stringstream compacted;
+  queue.serialize(compacted, true);
+  EXPECT_LT(compacted.str().size(), lazy.str().size());
+  restored = queue_type::deserialize(compacted);
+  EXPECT_EQ(pop_all(restored), pop_all(queue));
+
+  std::stringstream garbage("not a snapshot");
+  EXPECT_THROW(queue_type::deserialize(garbage), std::runtime_error);
+  std::stringstream truncated(lazy.str().substr(0, lazy.str().size() - 1));
+  EXPECT_THROW(queue_type::deserialize(truncated), std::runtime_error);
+  std::stringstream wider(lazy.str());
+  EXPECT_THROW(lazy_priority_queue<long long>::deserialize(wider),
+               std::runtime_error);
+  std::stringstream binary(lazy.str());
+  EXPECT_THROW(lazy_priority_queue<int>::deserialize(binary),
+               std::runtime_error);
+
+  // A corrupt count fails cleanly instead of allocating that many elements
+  auto oversized = lazy.str();
+  const std::uint64_t huge_size = std::uint64_t{1} << 60;
+  std::memcpy(oversized.data() +
+                  offsetof(lazy_priority_queue_snapshot_header, insert_size),
+              &huge_size, sizeof(huge_size));
+  std::stringstream seekable(oversized);
+  EXPECT_THROW(queue_type::deserialize(seekable), std::runtime_error);
+  unseekable_buffer buffer(oversized);
+  std::istream unseekable(&buffer);
+  EXPECT_THROW(queue_type::deserialize(unseekable), std::runtime_error);
+}
+
+TEST(InterfaceTest, Stats) {
+  static_assert(std::is_empty_v<no_stats>);
+  lazy_priority_queue<int, std::vector<int>, std::less<int>, binary_heap,
+                      counting_stats>
+      queue;
+  EXPECT_EQ(queue.stats().pushes, 0);
+
+  const std::vector<int> values{1, 2, 3, 4, 5, 6};
+  queue.push(values.cbegin(), values.cend());
+  queue.push(7);
+  queue.erase(6);
+  queue.erase(7);
+  queue.erase(2);
+  EXPECT_EQ(queue.top(), 5);
+  queue.pop();
+  queue.compact();
+
+  const auto stats = queue.stats();
+  EXPECT_EQ(stats.pushes, 7);
+  EXPECT_EQ(stats.erases, 3);
+  EXPECT_EQ(stats.annihilations, 3);
+  EXPECT_EQ(stats.longest_purge, 2);
+  EXPECT_EQ(stats.compactions, 1);
+  EXPECT_EQ(stats.max_insert_size, 7);
+  EXPECT_EQ(stats.max_remove_size, 2);
+
+  EXPECT_EQ(lazy_priority_queue<int>().stats().pushes, 0);
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "lazy_coalesced_priority_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+TEST(LazyCoalescedPriorityQueueTest, BasicAssertions) {
+  lazy_coalesced_priority_queue<int> queue;
+  EXPECT_EQ(queue.size(), 0);
+  EXPECT_TRUE(queue.empty());
+
+  queue.push(1);
+  EXPECT_EQ(queue.size(), 1);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.push(3);
+  EXPECT_EQ(queue.size(), 2);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 3);
+
+  queue.push(2);
+  EXPECT_EQ(queue.size(), 3);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 3);
+
+  queue.erase(2);
+  EXPECT_EQ(queue.size(), 2);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 3);
+
+  queue.pop();
+  EXPECT_EQ(queue.size(), 1);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(LazyCoalescedPriorityQueueTest, CoalesceInsertions) {
+  lazy_coalesced_priority_queue<std::string> queue;
+  for (int i = 0; i < 100; ++i) {
+    queue.push("hello");
+    queue.push("world");
+  }
+  EXPECT_EQ(queue.size(), 200);
+  EXPECT_EQ(queue.heap_size(), 2);
+
+  for (int i = 0; i < 99; ++i) {
+    queue.erase("world");
+  }
+  EXPECT_EQ(queue.size(), 101);
+  EXPECT_EQ(queue.top(), "world");
+  queue.pop();
+  EXPECT_EQ(queue.heap_size(), 1);
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_FALSE(queue.empty());
+    EXPECT_EQ(queue.top(), "hello");
+    queue.pop();
+  }
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.heap_size(), 0);
+}
+
+TEST(LazyCoalescedPriorityQueueTest, CoalesceRemovalsOnly) {
+  const std::vector<int> values{4, 4, 1, 4, 2, 1};
+  lazy_coalesced_priority_queue<int, std::greater<int>, std::hash<int>,
+                                std::equal_to<int>, false>
+      queue(values.cbegin(), values.cend(), std::greater<int>());
+  EXPECT_EQ(queue.heap_size(), 6);
+
+  queue.erase(values.cbegin(), values.cbegin() + 3);
+  EXPECT_EQ(queue.size(), 3);
+
+  EXPECT_EQ(queue.top(), 1);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 2);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 4);
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+}
\ No newline at end of file
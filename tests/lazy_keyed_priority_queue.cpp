@@ -0,0 +1,114 @@
+#include "lazy_keyed_priority_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
+
+struct Payload {
+  int priority{};
+  int id{};
+  std::array<char, 120> data{};
+};
+
+struct PayloadKey {
+  std::pair<int, int> operator()(const Payload& payload) const {
+    return {payload.priority, payload.id};
+  }
+};
+
+TEST(LazyKeyedPriorityQueueTest, BasicAssertions) {
+  lazy_keyed_priority_queue<Payload, PayloadKey> queue;
+  EXPECT_EQ(queue.size(), 0);
+  EXPECT_TRUE(queue.empty());
+
+  queue.push(Payload{1, 0, {'a'}});
+  EXPECT_EQ(queue.size(), 1);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top().data[0], 'a');
+
+  queue.push(Payload{3, 1, {'b'}});
+  EXPECT_EQ(queue.size(), 2);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top().data[0], 'b');
+
+  queue.emplace(Payload{3, 2, {'c'}});
+  EXPECT_EQ(queue.size(), 3);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top().data[0], 'c');
+
+  queue.erase({3, 2});
+  EXPECT_EQ(queue.size(), 2);
+  ASSERT_FALSE(queue.empty());
+  const auto& view = queue;
+  EXPECT_EQ(view.top().data[0], 'b');
+
+  queue.pop();
+  EXPECT_EQ(queue.size(), 1);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top().data[0], 'a');
+
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(LazyKeyedPriorityQueueTest, Compare) {
+  std::vector<Payload> payloads;
+  for (int id = 0; id < 100; ++id) {
+    payloads.push_back({id % 10, id, {}});
+  }
+  const auto key_of = PayloadKey();
+  lazy_keyed_priority_queue<Payload, PayloadKey, std::deque<Payload>,
+                            std::greater<std::pair<int, int>>,
+                            d_ary_heap<4>>
+      queue(payloads.cbegin(), payloads.cend(),
+            std::greater<std::pair<int, int>>(), key_of);
+
+  std::vector<std::pair<int, int>> keys;
+  for (int id = 0; id < 100; id += 2) {
+    keys.push_back(queue.key_of(payloads[id]));
+  }
+  queue.erase(keys.cbegin(), keys.cend());
+  EXPECT_EQ(queue.size(), 50);
+
+  for (int priority = 1; priority < 10; priority += 2) {
+    for (int id = priority; id < 100; id += 10) {
+      ASSERT_FALSE(queue.empty());
+      EXPECT_EQ(key_of(queue.top()), std::make_pair(priority, id));
+      queue.pop();
+    }
+  }
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(LazyKeyedPriorityQueueTest, Compaction) {
+  lazy_keyed_priority_queue<Payload, PayloadKey> queue;
+  queue.compaction_threshold(0.5);
+  EXPECT_EQ(queue.compaction_threshold(), 0.5);
+  for (int id = 0; id < 100; ++id) {
+    queue.push(Payload{id % 10, id, {}});
+  }
+  // Removes the lowest priorities, which never reach the top
+  for (int id = 0; id < 100; ++id) {
+    if (id % 10 < 6) {
+      queue.erase({id % 10, id});
+    }
+  }
+  EXPECT_EQ(queue.size(), 40);
+
+  queue.compact();
+  EXPECT_EQ(queue.size(), 40);
+  for (int priority = 9; priority >= 6; --priority) {
+    for (int id = 90 + priority; id >= 0; id -= 10) {
+      ASSERT_FALSE(queue.empty());
+      const auto payload = queue.extract_top();
+      EXPECT_EQ(payload.priority, priority);
+      EXPECT_EQ(payload.id, id);
+    }
+  }
+  EXPECT_TRUE(queue.empty());
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "lazy_radix_priority_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "lib.hpp"
+
+TEST(LazyRadixPriorityQueueTest, BasicAssertions) {
+  lazy_radix_priority_queue<unsigned int> queue;
+  EXPECT_EQ(queue.size(), 0);
+  EXPECT_TRUE(queue.empty());
+
+  queue.push(1);
+  EXPECT_EQ(queue.size(), 1);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.push(3);
+  EXPECT_EQ(queue.size(), 2);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.push(2);
+  EXPECT_EQ(queue.size(), 3);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.erase(2);
+  EXPECT_EQ(queue.size(), 2);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 1);
+
+  queue.pop();
+  EXPECT_EQ(queue.size(), 1);
+  ASSERT_FALSE(queue.empty());
+  EXPECT_EQ(queue.top(), 3);
+
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(LazyRadixPriorityQueueTest, Duplicates) {
+  const std::vector<std::uint8_t> keys{7, 7, 0, 255, 7, 0};
+  lazy_radix_priority_queue<std::uint8_t, std::deque<std::uint8_t>> queue(
+      keys.cbegin(), keys.cend());
+  queue.erase(7);
+  queue.erase(0);
+  EXPECT_EQ(queue.size(), 4);
+
+  EXPECT_EQ(queue.top(), 0);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 7);
+  queue.push(7);
+  queue.erase(7);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 7);
+  queue.pop();
+  EXPECT_EQ(queue.top(), 255);
+  queue.pop();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(LazyRadixPriorityQueueTest, Monotone) {
+  // Mirrors a timer queue where new deadlines never precede the current one
+  lazy_radix_priority_queue<std::uint64_t> radix;
+  lazy_priority_queue<std::uint64_t, std::vector<std::uint64_t>,
+                      std::greater<std::uint64_t>>
+      reference;
+  std::mt19937 gen(0);
+  for (std::uint64_t key = 0; key < 100; ++key) {
+    radix.push(key * 1'000'000'007);
+    reference.push(key * 1'000'000'007);
+  }
+
+  for (int step = 0; step < 10'000 && !reference.empty(); ++step) {
+    ASSERT_FALSE(radix.empty());
+    ASSERT_EQ(radix.size(), reference.size());
+    const auto key = reference.top();
+    ASSERT_EQ(radix.top(), key);
+    radix.pop();
+    reference.pop();
+
+    if (step < 5'000) {
+      const std::uint64_t later = key + gen() % 1'000;
+      const std::uint64_t cancelled = key + gen();
+      const std::vector<std::uint64_t> keys{later, cancelled};
+      radix.push(keys.cbegin(), keys.cend());
+      reference.push(keys.cbegin(), keys.cend());
+      radix.erase(cancelled);
+      reference.erase(cancelled);
+    }
+  }
+  EXPECT_TRUE(radix.empty());
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "lazy_timer_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using timer_queue = lazy_timer_queue<int>;
+using std::chrono::seconds;
+
+namespace {
+
+[[nodiscard]] timer_queue::time_point at(int second) {
+  return timer_queue::time_point(seconds(second));
+}
+
+[[nodiscard]] std::vector<int> pop_expired(timer_queue& queue, int second) {
+  std::vector<int> fired;
+  queue.pop_expired(at(second), std::back_inserter(fired));
+  return fired;
+}
+
+}  // namespace
+
+TEST(LazyTimerQueueTest, BasicAssertions) {
+  timer_queue queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(pop_expired(queue, 10).empty());
+
+  const auto first = queue.schedule(at(20), 1);
+  const auto second = queue.schedule(at(30), 2);
+  const auto third = queue.schedule(at(20), 3);
+  queue.schedule(at(40), 4);
+  EXPECT_EQ(queue.size(), 4);
+  EXPECT_EQ(queue.next_deadline(), at(20));
+
+  EXPECT_TRUE(queue.cancel(third));
+  EXPECT_EQ(queue.size(), 3);
+  EXPECT_TRUE(pop_expired(queue, 19).empty());
+  EXPECT_EQ(pop_expired(queue, 20), std::vector<int>{1});
+  EXPECT_FALSE(queue.cancel(first));  // already fired
+  EXPECT_EQ(queue.next_deadline(), at(30));
+
+  EXPECT_TRUE(queue.cancel(second));
+  EXPECT_EQ(queue.next_deadline(), at(40));
+  EXPECT_EQ(queue.size(), 1);
+
+  // Deadlines in the past fire on the next call, after earlier timers
+  const auto late = queue.schedule(at(10), 5);
+  EXPECT_EQ(late.deadline, at(20));
+  EXPECT_EQ(pop_expired(queue, 50), (std::vector<int>{5, 4}));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(LazyTimerQueueTest, Random) {
+  timer_queue queue;
+  std::map<std::pair<timer_queue::time_point, int>, timer_queue::handle>
+      expected;
+  std::mt19937 gen(0);
+  int now = 0;
+  for (int value = 0; value < 10000; ++value) {
+    const auto handle = queue.schedule(at(now + gen() % 1000), value);
+    expected.emplace(std::make_pair(handle.deadline, value), handle);
+    // Cancels most timers
+    if (gen() % 4 != 0) {
+      auto it = expected.lower_bound({at(gen() % (now + 1000)), 0});
+      if (it != expected.end()) {
+        EXPECT_TRUE(queue.cancel(it->second));
+        expected.erase(it);
+      }
+    }
+    if (value % 100 == 0) {
+      now += gen() % 100;
+      std::vector<timer_queue::handle> handles;
+      std::vector<int> fired;
+      while (!expected.empty() && expected.begin()->first.first <= at(now)) {
+        handles.push_back(expected.begin()->second);
+        fired.push_back(expected.begin()->first.second);
+        expected.erase(expected.begin());
+      }
+      ASSERT_EQ(pop_expired(queue, now), fired);
+      for (const auto& handle : handles) {
+        EXPECT_FALSE(queue.cancel(handle));
+      }
+    }
+    ASSERT_EQ(queue.size(), static_cast<int>(expected.size()));
+  }
+}
\ No newline at end of file
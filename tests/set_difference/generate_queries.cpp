@@ -2,6 +2,13 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <set>
+#include <vector>
+
 TEST(GenerateRandomQueriesTest, NumInsertions) {
   {  // num_insertions = 4
     const std::vector<int> expected{4, 9, 3, 0, -1, -5};
@@ -81,4 +88,66 @@ TEST(GenerateRandomQueriesTest, Seeds) {
     const auto actual = generate_random_queries(5, 2, 10, 2);
     EXPECT_EQ(actual, expected);
   }
+}
+
+TEST(GenerateRandomQueriesParallelTest, Philox) {
+  // Known-answer tests from the Random123 distribution
+  EXPECT_EQ(philox4x32({0, 0, 0, 0}, {0, 0}),
+            (std::array<std::uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                          0x9b00dbd8}));
+  EXPECT_EQ(philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                       {0xa4093822, 0x299f31d0}),
+            (std::array<std::uint32_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420,
+                                          0x24126ea1}));
+}
+
+TEST(GenerateRandomQueriesParallelTest, RandomPermutation) {
+  for (const std::uint64_t size : {1, 2, 5, 16, 17, 1000}) {
+    std::vector<std::uint64_t> positions;
+    for (std::uint64_t index = 0; index < size; ++index) {
+      positions.push_back(random_permutation(index, size, 3));
+    }
+    std::sort(positions.begin(), positions.end());
+    for (std::uint64_t index = 0; index < size; ++index) {
+      EXPECT_EQ(positions[index], index);
+    }
+  }
+}
+
+TEST(GenerateRandomQueriesParallelTest, ThreadCount) {
+  std::vector<int> expected;
+  generate_random_queries_parallel(1'000, 600, 50, 0,
+                                   std::back_inserter(expected), 1);
+  ASSERT_EQ(expected.size(), 1'600);
+
+  for (unsigned int num_threads = 2; num_threads <= 4; ++num_threads) {
+    std::vector<int> actual;
+    generate_random_queries_parallel(1'000, 600, 50, 0,
+                                     std::back_inserter(actual), num_threads,
+                                     37);
+    EXPECT_EQ(actual, expected);
+  }
+
+  std::vector<int> other_seed;
+  generate_random_queries_parallel(1'000, 600, 50, 1,
+                                   std::back_inserter(other_seed));
+  EXPECT_NE(other_seed, expected);
+}
+
+TEST(GenerateRandomQueriesParallelTest, Queries) {
+  std::vector<int> queries;
+  generate_random_queries_parallel(1'000, 1'000, 10, 4,
+                                   std::back_inserter(queries), 2, 100);
+  std::multiset<int> inserted;
+  for (const auto& query : queries) {
+    if (query >= 0) {
+      EXPECT_LT(query, 10);
+      inserted.insert(query);
+    } else {
+      const auto it = inserted.find(~query);
+      ASSERT_NE(it, inserted.end());
+      inserted.erase(it);
+    }
+  }
+  EXPECT_TRUE(inserted.empty());
 }
\ No newline at end of file
@@ -17,6 +17,16 @@ TEST(ProcessQueriesTest, Sort) {
   }
 }
 
+TEST(ProcessQueriesTest, Radix) {
+  for (const auto& [queries, expected] : queries_expected) {
+    const auto actual = process_queries_radix(queries);
+    EXPECT_EQ(actual, expected);
+  }
+
+  const auto queries = generate_random_queries(10'000, 5'000, 1'000'000'000, 3);
+  EXPECT_EQ(process_queries_radix(queries), process_queries_sort(queries));
+}
+
 TEST(ProcessQueriesTest, Multiset) {
   for (const auto& [queries, expected] : queries_expected) {
     const auto actual = process_queries_multiset(queries);
@@ -29,4 +39,44 @@ TEST(ProcessQueriesTest, LazyPQ) {
     const auto actual = process_queries_lazypq(queries);
     EXPECT_EQ(actual, expected);
   }
+}
+
+TEST(ProcessQueriesTest, Parallel) {
+  for (const auto& [queries, expected] : queries_expected) {
+    for (unsigned int num_threads = 1; num_threads <= 4; ++num_threads) {
+      const auto actual = process_queries_parallel(queries, num_threads);
+      EXPECT_EQ(actual, expected);
+    }
+  }
+
+  // Enough queries for three threads
+  const auto queries = generate_random_queries(
+      2 * min_queries_per_thread, min_queries_per_thread, 1'000'000, 2);
+  EXPECT_EQ(process_queries_parallel(queries, 3),
+            process_queries_sort(queries));
+  EXPECT_TRUE(process_queries_parallel({}, 2).empty());
+}
+
+TEST(ProcessQueriesTest, Counting) {
+  for (const auto& [queries, expected] : queries_expected) {
+    const auto actual = process_queries_counting(queries);
+    EXPECT_EQ(actual, expected);
+  }
+
+  // Values too large for an array of counts
+  const auto queries = generate_random_queries(10'000, 5'000, 1'000'000'000, 4);
+  ASSERT_FALSE(counts_in_array(max_query_value(queries), queries.size()));
+  EXPECT_EQ(process_queries_counting(queries), process_queries_sort(queries));
+}
+
+TEST(ProcessQueriesTest, Dispatch) {
+  for (const auto& [queries, expected] : queries_expected) {
+    const auto actual = process_queries(queries);
+    EXPECT_EQ(actual, expected);
+  }
+
+  for (const unsigned int max_value : {1'000U, 1'000'000'000U}) {
+    const auto queries = generate_random_queries(10'000, 5'000, max_value, 5);
+    EXPECT_EQ(process_queries(queries), process_queries_sort(queries));
+  }
 }
\ No newline at end of file
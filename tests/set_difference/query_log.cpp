@@ -0,0 +1,85 @@
+#include "set_difference/query_log.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "set_difference/generate_queries.hpp"
+#include "set_difference/process_queries.hpp"
+
+/// @brief Returns a path in the temporary directory unique to the test.
+[[nodiscard]] std::string temp_path(const std::string& name) {
+  return (std::filesystem::temp_directory_path() /
+          ("query_log_test_" + name + ".bin"))
+      .string();
+}
+
+TEST(QueryLogTest, RoundTrip) {
+  const auto path = temp_path("round_trip");
+  const auto queries = generate_random_queries(1'000, 400, 100, 0);
+  write_query_log(path, queries);
+
+  query_log_reader log(path, 64);
+  EXPECT_EQ(log.size(), queries.size());
+  std::vector<int> actual;
+  for (std::vector<int> chunk; log.read(chunk);) {
+    EXPECT_LE(chunk.size(), 64);
+    actual.insert(actual.end(), chunk.cbegin(), chunk.cend());
+  }
+  EXPECT_EQ(actual, queries);
+  std::filesystem::remove(path);
+}
+
+TEST(QueryLogTest, Writer) {
+  const auto path = temp_path("writer");
+  {
+    query_log_writer writer(path);
+    writer.write(3);
+    writer.write(1);
+    writer.write(~3);
+  }
+
+  query_log_reader log(path);
+  std::vector<int> chunk;
+  EXPECT_TRUE(log.read(chunk));
+  EXPECT_EQ(chunk, std::vector<int>({3, 1, ~3}));
+  EXPECT_FALSE(log.read(chunk));
+  EXPECT_TRUE(chunk.empty());
+  std::filesystem::remove(path);
+}
+
+TEST(QueryLogTest, ProcessQueries) {
+  const auto path = temp_path("process_queries");
+  const auto queries = generate_random_queries(10'000, 5'000, 1'000, 1);
+  write_query_log(path, queries);
+  const auto expected = process_queries_sort(queries);
+
+  query_log_reader multiset_log(path, 1'000);
+  EXPECT_EQ(process_queries_multiset(multiset_log), expected);
+  query_log_reader lazypq_log(path, 1'000);
+  EXPECT_EQ(process_queries_lazypq(lazypq_log), expected);
+  std::filesystem::remove(path);
+}
+
+TEST(QueryLogTest, Errors) {
+  EXPECT_THROW(query_log_reader(temp_path("missing")), std::runtime_error);
+
+  const auto path = temp_path("errors");
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "not a query log";
+  }
+  EXPECT_THROW(query_log_reader{path}, std::runtime_error);
+
+  write_query_log(path, {1, 2, 3});
+  std::filesystem::resize_file(path, sizeof(query_log_header) + sizeof(int));
+  query_log_reader log(path);
+  std::vector<int> chunk;
+  EXPECT_THROW(log.read(chunk), std::runtime_error);
+  std::filesystem::remove(path);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "simd.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "heap.hpp"
+#include "lib.hpp"
+
+#ifdef LAZY_PRIORITY_QUEUE_X86_SIMD
+template <std::size_t Arity, class T>
+void expect_best_of_matches_scalar() {
+  if (!simd::supported<Arity, T>()) {
+    GTEST_SKIP() << "the CPU does not support this kernel";
+  }
+  std::mt19937 gen(0);
+  std::vector<T> keys(Arity);
+  for (int round = 0; round < 1'000; ++round) {
+    // Few distinct keys, so that ties are common
+    std::generate(keys.begin(), keys.end(),
+                  [&gen] { return static_cast<T>(gen() % 4); });
+    const auto greatest = static_cast<std::size_t>(
+        std::max_element(keys.cbegin(), keys.cend()) - keys.cbegin());
+    const auto least = static_cast<std::size_t>(
+        std::min_element(keys.cbegin(), keys.cend()) - keys.cbegin());
+    EXPECT_EQ((simd::best_of<Arity, true>(keys.data())), greatest);
+    EXPECT_EQ((simd::best_of<Arity, false>(keys.data())), least);
+  }
+}
+
+TEST(SimdTest, Int) {
+  expect_best_of_matches_scalar<4, int>();
+  expect_best_of_matches_scalar<8, int>();
+}
+
+TEST(SimdTest, Float) {
+  expect_best_of_matches_scalar<4, float>();
+  expect_best_of_matches_scalar<8, float>();
+}
+
+TEST(SimdTest, Double) {
+  expect_best_of_matches_scalar<4, double>();
+  expect_best_of_matches_scalar<8, double>();
+}
+
+TEST(SimdTest, UInt64) {
+  expect_best_of_matches_scalar<4, std::uint64_t>();
+  expect_best_of_matches_scalar<8, std::uint64_t>();
+  const std::vector<std::uint64_t> keys{1, UINT64_MAX, 0, UINT64_MAX - 1};
+  EXPECT_EQ((simd::best_of<4, true>(keys.data())), 1);
+  EXPECT_EQ((simd::best_of<4, false>(keys.data())), 2);
+}
+#endif
+
+#ifdef LAZY_PRIORITY_QUEUE_NO_SIMD
+TEST(SimdTest, Disabled) {
+  EXPECT_FALSE((simd::is_vectorizable_v<4, int*, std::less<int>>));
+  EXPECT_FALSE((simd::is_vectorizable_v<8, double*, std::greater<double>>));
+}
+#endif
+
+template <class T, class Compare, class Heap>
+void expect_sorted_drain() {
+  std::mt19937 gen(1);
+  std::vector<T> values(1'000);
+  std::generate(values.begin(), values.end(),
+                [&gen] { return static_cast<T>(gen() % 500); });
+  lazy_priority_queue<T, std::vector<T>, Compare, Heap> queue(
+      values.cbegin(), values.cend());
+  for (std::size_t index = 0; index < values.size(); index += 3) {
+    queue.erase(values[index]);
+  }
+
+  std::vector<T> drained;
+  while (!queue.empty()) {
+    drained.push_back(queue.extract_top());
+  }
+  EXPECT_EQ(drained.size(), values.size() - (values.size() + 2) / 3);
+  EXPECT_TRUE(std::is_sorted(drained.crbegin(), drained.crend(), Compare()));
+}
+
+TEST(SimdTest, Heap) {
+  expect_sorted_drain<int, std::less<int>, d_ary_heap<4>>();
+  expect_sorted_drain<int, std::greater<int>, d_ary_heap<8>>();
+  expect_sorted_drain<float, std::less<>, d_ary_heap<8>>();
+  expect_sorted_drain<double, std::greater<double>, d_ary_heap<4>>();
+  expect_sorted_drain<std::uint64_t, std::less<std::uint64_t>,
+                      d_ary_heap<8>>();
+}
\ No newline at end of file